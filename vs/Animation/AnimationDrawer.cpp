@@ -4,32 +4,24 @@
 #include <iostream>
 
 AnimationDrawer::AnimationDrawer(int grid_size, int rows, int cols, float rate, bool loop)
-	: current_row(0)
+	: grid_size(grid_size)
+	, loop(loop)
+	, cycled(false)
+	, current_row(0)
 	, current_col(0)
 	, rows(rows)
 	, cols(cols)
-	, loop(loop)
-	, cycled(false)
-	, grid_size(grid_size)
 	, current_timer(0)
-	, rate(rate)
-{
-	initUVMap();
-}
+	, rate(rate) { }
 
 // NOTE: THIS ASSUMES TEXTURE MAP IS SQUARE WITH TEXTURES CONTAINED WITHIN SUBSQUARES
-// The only downside to this approach is that the UV map is created for every entity!
-void AnimationDrawer::initUVMap() {
-	float step_size = 1.0f / (grid_size - 1);
-	for (int r = 0; r < grid_size; ++r) {
-		std::vector<std::pair<float, float>> row;
-		for (int c = 0; c < grid_size; ++c) {
-			float u = (float)c * step_size;
-			float v = 1 - (float)r * step_size; // store top to bottom
-			row.push_back(std::make_pair(u, v));
-		}
-		uvs.push_back(row);
-	}
+// Grid points are worked out as needed rather than kept in a UV map per entity
+float AnimationDrawer::u(int col) const {
+	return static_cast<float>(col) / (grid_size - 1);
+}
+
+float AnimationDrawer::v(int row) const {
+	return 1 - static_cast<float>(row) / (grid_size - 1); // top to bottom
 }
 
 void AnimationDrawer::update(float dt) {
@@ -54,18 +46,42 @@ void AnimationDrawer::next_texture() {
 	}
 }
 
-void AnimationDrawer::draw() const {
+std::array<float, 4> AnimationDrawer::getFrame() const {
+	return { u(current_col), v(current_row + 1), u(current_col + 1), v(current_row) };
+}
+
+void AnimationDrawer::begin() {
+	glDisable(GL_LIGHTING);
+	glEnable(GL_TEXTURE_2D);
 	glColor3f(1.0, 1.0, 1.0);
-	glPushMatrix();
-		glBegin(GL_QUADS);
-			glTexCoord2f(uvs[current_row + 1][current_col].first, uvs[current_row + 1][current_col].second); glVertex3f(-0.5, -0.5, 0.0);
-			glTexCoord2f(uvs[current_row + 1][current_col + 1].first, uvs[current_row + 1][current_col + 1].second); glVertex3f(0.5, -0.5, 0.0);
-			glTexCoord2f(uvs[current_row][current_col + 1].first, uvs[current_row][current_col + 1].second); glVertex3f(0.5, 0.5, 0.0);
-			glTexCoord2f(uvs[current_row][current_col].first, uvs[current_row][current_col].second); glVertex3f(-0.5, 0.5, 0.0);
-		glEnd();
-	glPopMatrix();
+}
+
+void AnimationDrawer::render(const std::array<float, 4>& frame) {
+	glBegin(GL_QUADS);
+		glTexCoord2f(frame[0], frame[1]); glVertex3f(-0.5, -0.5, 0.0);
+		glTexCoord2f(frame[2], frame[1]); glVertex3f(0.5, -0.5, 0.0);
+		glTexCoord2f(frame[2], frame[3]); glVertex3f(0.5, 0.5, 0.0);
+		glTexCoord2f(frame[0], frame[3]); glVertex3f(-0.5, 0.5, 0.0);
+	glEnd();
+}
+
+void AnimationDrawer::end() {
+	glDisable(GL_TEXTURE_2D);
+	glEnable(GL_LIGHTING);
 }
 
 bool AnimationDrawer::hasCycled() const {
 	return cycled;
-}
\ No newline at end of file
+}
+
+int AnimationDrawer::getFrameIndex() const {
+	return current_row * (cols + 1) + current_col;
+}
+
+void AnimationDrawer::setFrameIndex(int index) {
+	const int cells = (rows + 1) * (cols + 1);
+	index = ((index % cells) + cells) % cells;
+	current_row = index / (cols + 1);
+	current_col = index % (cols + 1);
+	current_timer = 0;
+}
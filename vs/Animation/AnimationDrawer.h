@@ -1,25 +1,37 @@
 #ifndef I3D_ANIMATIONDRAWER_H
 #define I3D_ANIMATIONDRAWER_H
 
-#include <vector>
-#include <utility>
+#include <array>
 
 // Composition over inheritance!
-// Converts an n by n grid from a square texture animation map into UV coordinates and renders accordingly 
+// Converts an n by n grid from a square texture animation map into UV coordinates and renders accordingly.
+// Plain data, so it doubles as an ECS component
 
 class AnimationDrawer {
 public:
 	AnimationDrawer(int grid_size, int rows, int cols, float rate, bool loop);
-	void initUVMap();
 	void update(float dt);
-	void draw() const;
 	void next_texture();
 
+	// UVs of the current frame as { left, bottom, right, top }
+	std::array<float, 4> getFrame() const;
+
+	// Render thread: draws a unit quad showing the given frame
+	static void begin();
+	static void render(const std::array<float, 4>& frame);
+	static void end();
+
 	bool hasCycled() const;
 
+	// Which cell the window's at, counting along the rows, for state streams.
+	// Setting it starts that cell's time over
+	int getFrameIndex() const;
+	void setFrameIndex(int index);
+
 private:
-	// Can't use 2D std::array since we don't know size at compile time
-	std::vector<std::vector<std::pair<float, float>>> uvs;
+	float u(int col) const;
+	float v(int row) const;
+
 	int grid_size;
 	bool loop;
 	bool cycled;
@@ -1,5 +1,4 @@
 #include "Arena.h"
-#include "GlutHeaders.h"
 #include "Enums/Enum.h"
 
 Arena::Arena() : skybox(Skybox()) {
@@ -11,50 +10,54 @@ Arena::Arena() : skybox(Skybox()) {
 	walls.emplace_back(Side::BACK);
 }
 
-void Arena::drawArena() const {
-	glPushMatrix();
+void Arena::recordArena(RenderFrame& frame) const {
 	for (const Wall& wall : walls) {
-		glPushMatrix();
-		// default wall is drawn in x/y plane, so rotations
-		// are only needed for walls in x/z and y/z planes
-		if (wall.getSide() == Side::TOP) {
-			glTranslatef(0, ARENA_DIM, 0);
-			glRotatef(90, 1, 0, 0);
-		}
-		else if (wall.getSide() == Side::BOTTOM) {
-			glTranslatef(0, -ARENA_DIM, 0);
-			glRotatef(90, 1, 0, 0);
-		}
-		else if (wall.getSide() == Side::LEFT) {
-			glTranslatef(-ARENA_DIM, 0, 0);
-			glRotatef(90, 0, 1, 0);
-		}
-		else if (wall.getSide() == Side::RIGHT) {
-			glTranslatef(ARENA_DIM, 0, 0);
-			glRotatef(90, 0, 1, 0);
-		}
-		else if (wall.getSide() == Side::FRONT) {
-			glTranslatef(0, 0, ARENA_DIM);
-		}
-		else if (wall.getSide() == Side::BACK) {
-			glTranslatef(0, 0, -ARENA_DIM);
-		}
-		glScalef(ARENA_DIM, ARENA_DIM, 0);
-		wall.draw();
-		glPopMatrix();
+		wall.record(frame);
 	}
-	glPopMatrix();
 }
 
-void Arena::drawSkybox() const {
-	skybox.draw();
+void Arena::recordSkybox(RenderFrame& frame) const {
+	skybox.record(frame);
 }
 
-void Arena::drawSatellite() const {
-	satellite.draw();
+void Arena::recordSatellite(RenderFrame& frame) const {
+	satellite.record(frame);
 }
 void Arena::updateSatellite(float dt) {
 	satellite.update(dt);
 }
 
-std::vector<Wall>& Arena::getWalls() { return walls; }
\ No newline at end of file
+std::vector<Wall>& Arena::getWalls() { return walls; }
+
+void Arena::save(Snapshot& snapshot) const {
+	for (const Wall& wall : walls) {
+		snapshot.write(wall.getColour());
+	}
+	satellite.save(snapshot);
+}
+
+void Arena::restore(Snapshot::Reader& reader) {
+	for (Wall& wall : walls) {
+		Colour colour;
+		reader.read(colour);
+		wall.setColour(colour);
+	}
+	satellite.restore(reader);
+}
+
+void Arena::captureState(WorldState& state) const {
+	state.red_walls = 0;
+	for (size_t i = 0; i < walls.size(); ++i) {
+		if (walls[i].getColour() == Colour::RED) {
+			state.red_walls |= 1 << i;
+		}
+	}
+	satellite.captureState(state);
+}
+
+void Arena::applyState(const WorldState& state) {
+	for (size_t i = 0; i < walls.size(); ++i) {
+		walls[i].setColour(state.red_walls & (1 << i) ? Colour::RED : Colour::WHITE);
+	}
+	satellite.applyState(state);
+}
\ No newline at end of file
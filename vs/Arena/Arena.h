@@ -5,6 +5,8 @@
 #include "Wall.h"
 #include "Satellite.h"
 #include "Skybox.h"
+#include "State/Snapshot.h"
+#include "State/WorldState.h"
 
 #include <vector>
 #include <memory>
@@ -12,14 +14,22 @@
 class Arena {
 public:
 	Arena();
-	void drawArena() const;
-	void drawSkybox() const;
+	void recordArena(RenderFrame& frame) const;
+	void recordSkybox(RenderFrame& frame) const;
 
-	void drawSatellite() const;
+	void recordSatellite(RenderFrame& frame) const;
 	void updateSatellite(float dt);
 
 	std::vector<Wall>& getWalls();
 
+	// The walls' colours and the satellite's orbit
+	void save(Snapshot& snapshot) const;
+	void restore(Snapshot::Reader& reader);
+
+	// Which walls are red, and the satellite
+	void captureState(WorldState& state) const;
+	void applyState(const WorldState& state);
+
 private:
 	Skybox skybox;
 	Satellite satellite;
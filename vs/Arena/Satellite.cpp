@@ -1,11 +1,18 @@
 #include "Satellite.h"
 #include "Constants/ArenaConstants.h"
 #include "Math/Utility.h"
+#include "Math/Matrix.h"
 
 #include "GlutHeaders.h"
 
 #include <iostream>
 
+namespace {
+	// the sphere's tessellation
+	int constexpr SLICES = 10;
+	int constexpr STACKS = 10;
+}
+
 Satellite::Satellite() :
 	position(sqrt(3) * ARENA_DIM * Vector3D::randomUnit()), // random position on the arena's bounding sphere
 	rotation_axis(Vector3D::cross(position, Vector3D::randomUnit())),
@@ -19,17 +26,52 @@ void Satellite::update(float dt) {
 	}
 }
 
-void Satellite::draw() const {
-	// The few times when scale -> translate -> rotate is correct!
-	glEnable(GL_LIGHTING);
-	glPushMatrix();
-		glRotatef(angle, rotation_axis.X, rotation_axis.Y, rotation_axis.Z);
-		glTranslatef(position.X, position.Y, position.Z);
-		glLightfv(GL_LIGHT1, GL_POSITION, Vector3D::toArray(position).data());
-		glColor3f(1.0, 1.0, 1.0);
-		glDisable(GL_LIGHTING);
-		glutSolidSphere(10, 10, 10);
-		glEnable(GL_LIGHTING);
-	glPopMatrix();
+// The few times when scale -> translate -> rotate is correct!
+void Satellite::record(RenderFrame& frame) const {
+	matrix::Matrix transform = matrix::multiply(
+		matrix::rotation(angle, rotation_axis), matrix::translation(position));
+
+	frame.record(RenderPass::opaque, Mesh::satellite, 0, transform,
+		{ position.X, position.Y, position.Z, 1.0 });
+}
+
+// Light 1 is placed in the satellite's own frame, so it moves with it.
+// GLU rather than glutSolidSphere so it still draws without a GLUT window
+void Satellite::render(const std::array<float, 4>& light_position) {
+	static GLUquadric* quadric = gluNewQuadric();
+
+	glLightfv(GL_LIGHT1, GL_POSITION, light_position.data());
+	glColor3f(1.0, 1.0, 1.0);
 	glDisable(GL_LIGHTING);
+	gluSphere(quadric, 10, SLICES, STACKS);
+}
+
+int Satellite::getTriangleCount() {
+	return 2 * SLICES * STACKS;
+}
+
+void Satellite::save(Snapshot& snapshot) const {
+	snapshot.write(position);
+	snapshot.write(rotation_axis);
+	snapshot.write(angle);
+	snapshot.write(speed);
+}
+
+void Satellite::restore(Snapshot::Reader& reader) {
+	reader.read(position);
+	reader.read(rotation_axis);
+	reader.read(angle);
+	reader.read(speed);
+}
+
+void Satellite::captureState(WorldState& state) const {
+	state.satellite_position = position;
+	state.satellite_axis = rotation_axis;
+	state.satellite_angle = angle;
+}
+
+void Satellite::applyState(const WorldState& state) {
+	position = state.satellite_position;
+	rotation_axis = state.satellite_axis;
+	angle = state.satellite_angle;
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define I3D_SATELLITE_H
 
 #include "Math/Vector3D.h"
+#include "Render/RenderFrame.h"
+#include "State/Snapshot.h"
+#include "State/WorldState.h"
 
 #include <array>
 
@@ -9,7 +12,15 @@ class Satellite {
 public:
 	Satellite();
 	void update(float dt);
-	void draw() const;
+	void record(RenderFrame& frame) const;
+	static void render(const std::array<float, 4>& light_position);
+	static int getTriangleCount();
+
+	void save(Snapshot& snapshot) const;
+	void restore(Snapshot::Reader& reader);
+
+	void captureState(WorldState& state) const;
+	void applyState(const WorldState& state);
 
 private:
 	Vector3D position;
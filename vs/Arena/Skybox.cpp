@@ -5,75 +5,59 @@
 
 #include <iostream>
 
+// Unit cube around the camera, wound to face inwards. The cube map is sampled
+// by direction, so each vertex doubles as its own texture coordinate
+static const float cube[] = {
+	// top
+	-0.5f, 0.5f, -0.5f,		0.5f, 0.5f, -0.5f,		0.5f, 0.5f, 0.5f,		-0.5f, 0.5f, 0.5f,
+	// bottom
+	-0.5f, -0.5f, 0.5f,		0.5f, -0.5f, 0.5f,		0.5f, -0.5f, -0.5f,		-0.5f, -0.5f, -0.5f,
+	// left
+	-0.5f, -0.5f, 0.5f,		-0.5f, -0.5f, -0.5f,	-0.5f, 0.5f, -0.5f,		-0.5f, 0.5f, 0.5f,
+	// right
+	0.5f, -0.5f, -0.5f,		0.5f, -0.5f, 0.5f,		0.5f, 0.5f, 0.5f,		0.5f, 0.5f, -0.5f,
+	// front
+	-0.5f, -0.5f, -0.5f,	0.5f, -0.5f, -0.5f,		0.5f, 0.5f, -0.5f,		-0.5f, 0.5f, -0.5f,
+	// back
+	0.5f, -0.5f, 0.5f,		-0.5f, -0.5f, 0.5f,		-0.5f, 0.5f, 0.5f,		0.5f, 0.5f, 0.5f,
+};
+
 Skybox::Skybox() {
-	top = Asset::getTextureId(Entity::skybox_top);
-	bottom = Asset::getTextureId(Entity::skybox_bottom);
-	left = Asset::getTextureId(Entity::skybox_left);
-	right = Asset::getTextureId(Entity::skybox_right);
-	front = Asset::getTextureId(Entity::skybox_front);
-	back = Asset::getTextureId(Entity::skybox_back);
+	cube_map = Asset::getTextureId(Entity::skybox);
+}
+
+// Always centred on the camera, so its transform is just the view rotation
+void Skybox::record(RenderFrame& frame) const {
+	frame.record(RenderPass::skybox, Mesh::skybox, cube_map, frame.view_rotation);
 }
 
-void Skybox::draw() const {
-	glPushAttrib(GL_ENABLE_BIT);
-	glEnable(GL_TEXTURE_2D);
-	glDisable(GL_DEPTH_TEST);
+// Meant to be drawn after all opaque geometry, with only the camera's rotation
+// on the modelview. Every fragment is forced onto the far plane, so it only
+// passes (and only gets shaded) where nothing has been drawn yet
+void Skybox::render(unsigned int cube_map) {
+	glPushAttrib(GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT | GL_VIEWPORT_BIT | GL_CURRENT_BIT);
+	glEnable(GL_TEXTURE_CUBE_MAP);
+	glEnable(GL_DEPTH_TEST);
 	glDisable(GL_LIGHTING);
 	glDisable(GL_BLEND);
 
-	glPushMatrix();
-		glBindTexture(GL_TEXTURE_2D, top);
-		glBegin(GL_QUADS);
-			glTexCoord2f(0, 0); glVertex3f(-0.5f, 0.5f, -0.5f);
-			glTexCoord2f(1, 0); glVertex3f(0.5f, 0.5f, -0.5f);
-			glTexCoord2f(1, 1); glVertex3f(0.5f, 0.5f, 0.5f);
-			glTexCoord2f(0, 1); glVertex3f(-0.5f, 0.5f, 0.5f);
-		glEnd();
+	glDepthRange(1.0, 1.0);
+	glDepthFunc(GL_LEQUAL);
+	glDepthMask(GL_FALSE);
 
-		glBindTexture(GL_TEXTURE_2D, bottom);
-		glBegin(GL_QUADS);
-			glTexCoord2f(0, 0); glVertex3f(-0.5f, -0.5f, 0.5f);
-			glTexCoord2f(1, 0); glVertex3f(0.5f, -0.5f, 0.5f);
-			glTexCoord2f(1, 1); glVertex3f(0.5f, -0.5f, -0.5f);
-			glTexCoord2f(0, 1); glVertex3f(-0.5f, -0.5f, -0.5f);
-		glEnd();
+	glColor3f(1.0, 1.0, 1.0);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, cube_map);
 
-		glBindTexture(GL_TEXTURE_2D, left);
-		glBegin(GL_QUADS);
-			glTexCoord2f(0, 0); glVertex3f(-0.5f, -0.5f, 0.5f);
-			glTexCoord2f(1, 0); glVertex3f(-0.5f, -0.5f, -0.5f);
-			glTexCoord2f(1, 1); glVertex3f(-0.5f, 0.5f, -0.5f);
-			glTexCoord2f(0, 1); glVertex3f(-0.5f, 0.5f, 0.5f);
-		glEnd();
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(3, GL_FLOAT, 0, cube);
+	glTexCoordPointer(3, GL_FLOAT, 0, cube);
 
-		glBindTexture(GL_TEXTURE_2D, right);
-		glBegin(GL_QUADS);
-			glTexCoord2f(0, 0); glVertex3f(0.5f, -0.5f, -0.5f);
-			glTexCoord2f(1, 0); glVertex3f(0.5f, -0.5f, 0.5f);
-			glTexCoord2f(1, 1); glVertex3f(0.5f, 0.5f, 0.5f);
-			glTexCoord2f(0, 1); glVertex3f(0.5f, 0.5f, -0.5f);
-		glEnd();
+	glDrawArrays(GL_QUADS, 0, 24);
 
-		glBindTexture(GL_TEXTURE_2D, front);
-		glBegin(GL_QUADS);
-			glTexCoord2f(0, 0); glVertex3f(-0.5f, -0.5f, -0.5f);
-			glTexCoord2f(1, 0); glVertex3f(0.5f, -0.5f, -0.5f);
-			glTexCoord2f(1, 1); glVertex3f(0.5f, 0.5f, -0.5f);
-			glTexCoord2f(0, 1); glVertex3f(-0.5f, 0.5f, -0.5f);
-		glEnd();
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
-		glBindTexture(GL_TEXTURE_2D, back);
-		glBegin(GL_QUADS);
-			glTexCoord2f(0, 0); glVertex3f(0.5f, -0.5f, 0.5f);
-			glTexCoord2f(1, 0); glVertex3f(-0.5f, -0.5f, 0.5f);
-			glTexCoord2f(1, 1); glVertex3f(-0.5f, 0.5f, 0.5f);
-			glTexCoord2f(0, 1); glVertex3f(0.5f, 0.5f, 0.5f);
-		glEnd();
-	glPopMatrix();
-
-	glEnable(GL_BLEND);
-	glEnable(GL_LIGHTING);
-	glEnable(GL_DEPTH_TEST);
-	glDisable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 	glPopAttrib();
-}
\ No newline at end of file
+}
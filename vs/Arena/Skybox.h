@@ -1,18 +1,16 @@
 #ifndef I3D_SKYBOX_H
 #define I3D_SKYBOX_H
 
+#include "Render/RenderFrame.h"
+
 class Skybox {
 public:
 	Skybox();
-	void draw() const;
+	void record(RenderFrame& frame) const;
+	static void render(unsigned int cube_map);
 
 private:
-	unsigned int top;
-	unsigned int bottom;
-	unsigned int left;
-	unsigned int right;
-	unsigned int front;
-	unsigned int back;
+	unsigned int cube_map;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,39 +1,100 @@
 #include "GlutHeaders.h"
 #include "Wall.h"
 #include "Constants/ArenaConstants.h"
+#include "Math/Matrix.h"
+
+Wall::Wall(Side side) : side(side), colour(Colour::WHITE) {}
+
+// Lines for a unit square in the x/y plane, uploaded to a static buffer when
+// the driver has them, otherwise drawn from client memory
+void Wall::buildGrid() {
+	if (!grid.empty()) {
+		return;
+	}
 
-Wall::Wall(Side side) : side(side), colour(Colour::WHITE) {
 	// minimum two outside edges per face
-	this->segments = WALL_SEGMENTS < 2 ? 2 : WALL_SEGMENTS;
+	const float segments = WALL_SEGMENTS < 2 ? 2 : WALL_SEGMENTS;
 
 	// 2.0f * WIDTH, but for a unit wall WIDTH = 1
-	this->spacing = 2.0f / segments;
+	const float spacing = 2.0f / segments;
+
+	for (int i = 0; i <= segments; ++i) {
+		// x-dim
+		grid.insert(grid.end(), { -1 + spacing * i, -1, 0 });
+		grid.insert(grid.end(), { -1 + spacing * i, 1, 0 });
+		// y-dim
+		grid.insert(grid.end(), { -1, -1 + spacing * i, 0 });
+		grid.insert(grid.end(), { 1, -1 + spacing * i, 0 });
+	}
+
+	grid_buffer = ResourceManager::createBuffer("wall grid");
+	if (grid_buffer) {
+		ResourceManager::bufferData(grid_buffer, GL_ARRAY_BUFFER, grid.size() * sizeof(float), grid.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
 }
 
-// Each wall is drawn as a unit square
-void Wall::draw() const {
+void Wall::bindGrid() {
 	glDisable(GL_LIGHTING);
+	glEnableClientState(GL_VERTEX_ARRAY);
 
-	if (colour == Colour::RED) {
-		glColor4f(1.0, 0.0, 0.0, 0.5);
-	}
-	else if (colour == Colour::WHITE) {
-		glColor4f(1.0, 1.0, 1.0, 0.1);
-	}
-
-	glBegin(GL_LINES);
-		for (int i = 0; i <= segments; ++i) {
-			// x-dim
-			glVertex3f(-1 + spacing * i, -1, 0);
-			glVertex3f(-1 + spacing * i, 1, 0);
-			// y-dim
-			glVertex3f(-1, -1 + spacing * i, 0);
-			glVertex3f(1, -1 + spacing * i, 0);
-		}
-	glEnd();
+	if (grid_buffer) {
+		glBindBuffer(GL_ARRAY_BUFFER, ResourceManager::getId(grid_buffer));
+		glVertexPointer(3, GL_FLOAT, 0, nullptr);
+	}
+	else {
+		glVertexPointer(3, GL_FLOAT, 0, grid.data());
+	}
+}
+
+void Wall::unbindGrid() {
+	if (grid_buffer) {
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
 	glEnable(GL_LIGHTING);
 	glColor3f(1.0, 1.0, 1.0);
 }
 
+// Each wall is drawn as a unit square in the x/y plane, so rotations
+// are only needed for walls in x/z and y/z planes
+void Wall::record(RenderFrame& frame) const {
+	matrix::Matrix placement = matrix::identity();
+	if (side == Side::TOP) {
+		placement = matrix::multiply(matrix::translation(Vector3D(0, ARENA_DIM, 0)), matrix::rotation(90, Vector3D(1, 0, 0)));
+	}
+	else if (side == Side::BOTTOM) {
+		placement = matrix::multiply(matrix::translation(Vector3D(0, -ARENA_DIM, 0)), matrix::rotation(90, Vector3D(1, 0, 0)));
+	}
+	else if (side == Side::LEFT) {
+		placement = matrix::multiply(matrix::translation(Vector3D(-ARENA_DIM, 0, 0)), matrix::rotation(90, Vector3D(0, 1, 0)));
+	}
+	else if (side == Side::RIGHT) {
+		placement = matrix::multiply(matrix::translation(Vector3D(ARENA_DIM, 0, 0)), matrix::rotation(90, Vector3D(0, 1, 0)));
+	}
+	else if (side == Side::FRONT) {
+		placement = matrix::translation(Vector3D(0, 0, ARENA_DIM));
+	}
+	else if (side == Side::BACK) {
+		placement = matrix::translation(Vector3D(0, 0, -ARENA_DIM));
+	}
+
+	std::array<float, 4> rgba = { 1.0, 1.0, 1.0, 0.1 };
+	if (colour == Colour::RED) {
+		rgba = { 1.0, 0.0, 0.0, 0.5 };
+	}
+
+	frame.record(RenderPass::opaque, Mesh::wall, 0,
+		matrix::multiply(placement, matrix::scale(ARENA_DIM, ARENA_DIM, 0)), rgba, static_cast<std::uint8_t>(colour));
+}
+
+// The grid must be bound, so the only per-wall state is its colour
+void Wall::render(const std::array<float, 4>& colour) {
+	glColor4fv(colour.data());
+	glDrawArrays(GL_LINES, 0, grid.size() / 3);
+}
+
 Side Wall::getSide() const { return side; }
-void Wall::setColour(const Colour colour) { this->colour = colour; }
\ No newline at end of file
+void Wall::setColour(const Colour colour) { this->colour = colour; }
+Colour Wall::getColour() const { return colour; }
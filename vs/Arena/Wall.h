@@ -3,20 +3,33 @@
 
 #include "Enums/Enum.h"
 #include "Math/Vector3D.h"
+#include "Render/RenderFrame.h"
+#include "Assets/ResourceManager.h"
+
+#include <vector>
 
 class Wall {
 public:
 	Wall(Side side);
-	void draw() const;
+	void record(RenderFrame& frame) const;
 
 	Side getSide() const;
 	void setColour(const Colour colour);
+	Colour getColour() const;
+
+	// Every wall is the same unit grid under a different transform, so the grid
+	// is built once and shared. bindGrid/unbindGrid bracket a batch of draws
+	static void buildGrid();
+	static void bindGrid();
+	static void render(const std::array<float, 4>& colour);
+	static void unbindGrid();
 
 private:
 	Side side;
 	Colour colour;
-	float segments;
-	float spacing;
+
+	inline static std::vector<float> grid;
+	inline static BufferHandle grid_buffer;
 };
 
-#endif
\ No newline at end of file
+#endif
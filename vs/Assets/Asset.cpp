@@ -4,14 +4,38 @@
 bool Asset::clamp = false;
 
 void Asset::loadAsset(Entity type, std::string path) {
-	unsigned int id = Texture::loadTexture(path, clamp);
-	textures.emplace(type, id);
+	store(type, Texture::loadTexture(path, clamp));
 }
 
+void Asset::loadAssetArray(Entity type, const std::vector<std::string>& paths) {
+	store(type, Texture::loadTextureArray(paths, clamp));
+}
+
+void Asset::loadCubeMap(Entity type, const std::array<std::string, 6>& paths) {
+	store(type, Texture::loadCubeMap(paths));
+}
+
+void Asset::store(Entity type, TextureHandle texture) {
+	auto found = textures.find(type);
+	if (found != textures.end()) {
+		ResourceManager::release(found->second.handle);
+	}
+	textures[type] = { texture, ResourceManager::getId(texture) };
+}
+
+// 0 for one that failed to load, e.g. an array texture without driver support
 unsigned int Asset::getTextureId(Entity type) {
-	return textures.find(type)->second;
+	auto found = textures.find(type);
+	return found != textures.end() ? found->second.id : 0;
 }
 
 void Asset::setClamp(bool setting) {
 	clamp = setting;
 }
+
+void Asset::clear() {
+	for (const auto& texture : textures) {
+		ResourceManager::release(texture.second.handle);
+	}
+	textures.clear();
+}
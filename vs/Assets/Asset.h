@@ -3,36 +3,44 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <array>
 
 #include "Enums/Enum.h"
+#include "ResourceManager.h"
 
 enum class Entity {
 	ship,
 
-	asteroid_1,
-	asteroid_2,
-	asteroid_3,
-	asteroid_4,
+	asteroid_array, // all asteroid textures as layers of one array texture
 
-	skybox_top,
-	skybox_bottom,
-	skybox_left,
-	skybox_right,
-	skybox_front,
-	skybox_back,
+	skybox, // cube map
 
 	bullets,
 
 	explosion
 };
 
+// Holds a reference to each loaded texture on the ResourceManager's behalf.
+// Loading a type again replaces its texture, releasing the old one
 class Asset {
 public:
 	static void loadAsset(Entity type, std::string path);
+	static void loadAssetArray(Entity type, const std::vector<std::string>& paths);
+	static void loadCubeMap(Entity type, const std::array<std::string, 6>& paths);
 	static unsigned int getTextureId(Entity type);
 	static void setClamp(bool setting);
-	inline static std::map<Entity, unsigned int> textures;
+	static void clear(); // releases every texture
 private:
+	static void store(Entity type, TextureHandle texture);
+
+	// The ids are looked up from the simulation thread, so they're kept here
+	// rather than asking the ResourceManager for them each time
+	struct Loaded {
+		TextureHandle handle;
+		unsigned int id;
+	};
+	inline static std::map<Entity, Loaded> textures;
 	static bool clamp;
 };
 
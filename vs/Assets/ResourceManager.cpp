@@ -0,0 +1,198 @@
+#include "ResourceManager.h"
+#include "GlutHeaders.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+	const char* kindName(ResourceKind kind) {
+		return kind == ResourceKind::texture ? "texture" : "buffer";
+	}
+
+	double toKiB(size_t bytes) {
+		return bytes / 1024.0;
+	}
+}
+
+TextureHandle ResourceManager::adoptTexture(unsigned int id, size_t bytes, const std::string& name) {
+	if (id == 0) {
+		return {};
+	}
+	const unsigned int index = add(ResourceKind::texture, id, bytes, name);
+	return { index, resources[index].generation };
+}
+
+BufferHandle ResourceManager::createBuffer(const std::string& name) {
+	if (!GLEW_VERSION_1_5) {
+		return {};
+	}
+	unsigned int id;
+	glGenBuffers(1, &id);
+	const unsigned int index = add(ResourceKind::buffer, id, 0, name);
+	return { index, resources[index].generation };
+}
+
+void ResourceManager::bufferData(BufferHandle buffer, unsigned int target, size_t bytes, const void* data, unsigned int usage) {
+	Resource* resource = find(ResourceKind::buffer, buffer.index, buffer.generation);
+	if (resource == nullptr) {
+		return;
+	}
+	glBindBuffer(target, resource->id);
+	glBufferData(target, bytes, data, usage);
+	resize(*resource, bytes);
+}
+
+ResourceManager::Resource* ResourceManager::find(ResourceKind kind, unsigned int index, unsigned int generation) {
+	if (index == 0 || index >= resources.size()) {
+		return nullptr;
+	}
+	Resource& resource = resources[index];
+	if (resource.id == 0 || resource.kind != kind || resource.generation != generation) {
+		return nullptr;
+	}
+	return &resource;
+}
+
+unsigned int ResourceManager::add(ResourceKind kind, unsigned int id, size_t bytes, const std::string& name) {
+	unsigned int index;
+	if (!free_slots.empty()) {
+		index = free_slots.back();
+		free_slots.pop_back();
+	}
+	else {
+		index = static_cast<unsigned int>(resources.size());
+		resources.emplace_back();
+	}
+
+	Resource& resource = resources[index];
+	resource.kind = kind;
+	resource.id = id;
+	resource.bytes = 0;
+	resource.references = 1;
+	resource.name = name;
+	resize(resource, bytes);
+	return index;
+}
+
+void ResourceManager::acquire(ResourceKind kind, unsigned int index, unsigned int generation) {
+	if (find(kind, index, generation) != nullptr) {
+		++resources[index].references;
+	}
+}
+
+// The slot is free again straight away; only the GL object has to wait
+void ResourceManager::release(ResourceKind kind, unsigned int index, unsigned int generation) {
+	if (find(kind, index, generation) == nullptr) {
+		return;
+	}
+	Resource& resource = resources[index];
+	if (--resource.references > 0) {
+		return;
+	}
+
+	void* fence = nullptr;
+	if (GLEW_VERSION_3_2 || GLEW_ARB_sync) {
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	released.push_back({ kind, resource.id, resource.bytes, fence, RESOURCE_RELEASE_FRAMES });
+
+	resource.id = 0;
+	resource.bytes = 0;
+	resource.name.clear();
+	++resource.generation;
+	free_slots.push_back(index);
+}
+
+// Stays resident until it's actually deleted, so it's not taken off here
+void ResourceManager::resize(Resource& resource, size_t bytes) {
+	resident_bytes = resident_bytes - resource.bytes + bytes;
+	resource.bytes = bytes;
+	peak_bytes = std::max(peak_bytes, resident_bytes);
+
+	if (resident_bytes > budget && !over_budget) {
+		std::cerr << "GPU resources over budget: " << toKiB(resident_bytes) << " KiB of "
+			<< toKiB(budget) << " KiB, after " << kindName(resource.kind) << " " << resource.name << std::endl;
+	}
+	over_budget = resident_bytes > budget;
+}
+
+void ResourceManager::destroy(const Released& resource) {
+	if (resource.kind == ResourceKind::texture) {
+		glDeleteTextures(1, &resource.id);
+	}
+	else {
+		glDeleteBuffers(1, &resource.id);
+	}
+	if (resource.fence != nullptr) {
+		glDeleteSync(static_cast<GLsync>(resource.fence));
+	}
+	resident_bytes -= resource.bytes;
+	over_budget = resident_bytes > budget;
+}
+
+void ResourceManager::collect() {
+	if (released.empty()) {
+		return;
+	}
+
+	auto done = [](Released& resource) {
+		bool finished;
+		if (resource.fence != nullptr) {
+			const GLenum status = glClientWaitSync(static_cast<GLsync>(resource.fence), 0, 0);
+			finished = status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+		}
+		else {
+			finished = --resource.frames <= 0;
+		}
+		if (finished) {
+			destroy(resource);
+		}
+		return finished;
+	};
+	released.erase(std::remove_if(released.begin(), released.end(), done), released.end());
+}
+
+void ResourceManager::flush() {
+	for (const Released& resource : released) {
+		destroy(resource);
+	}
+	released.clear();
+}
+
+void ResourceManager::setBudget(size_t bytes) {
+	budget = bytes;
+	over_budget = resident_bytes > budget;
+}
+
+size_t ResourceManager::getBudget() {
+	return budget;
+}
+
+size_t ResourceManager::getResidentBytes() {
+	return resident_bytes;
+}
+
+void ResourceManager::report(std::ostream& out) {
+	std::vector<const Resource*> live;
+	for (const Resource& resource : resources) {
+		if (resource.id != 0) {
+			live.push_back(&resource);
+		}
+	}
+	std::sort(live.begin(), live.end(), [](const Resource* a, const Resource* b) {
+		return a->bytes > b->bytes;
+	});
+
+	out << std::fixed << std::setprecision(1);
+	for (const Resource* resource : live) {
+		out << "  " << std::setw(7) << kindName(resource->kind)
+			<< std::setw(10) << toKiB(resource->bytes) << " KiB  "
+			<< resource->references << (resource->references == 1 ? " ref   " : " refs  ")
+			<< resource->name << std::endl;
+	}
+	out << "GPU resources: " << live.size() << " live, " << released.size() << " awaiting deletion, "
+		<< toKiB(resident_bytes) << " KiB of " << toKiB(budget) << " KiB budget (peak "
+		<< toKiB(peak_bytes) << " KiB)" << std::endl;
+	out << std::defaultfloat;
+}
@@ -0,0 +1,112 @@
+#ifndef I3D_RESOURCEMANAGER_H
+#define I3D_RESOURCEMANAGER_H
+
+#include "Constants/RenderConstants.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class ResourceKind {
+	texture,
+	buffer
+};
+
+// Refers to a slot in the ResourceManager. The generation catches a handle
+// kept past its release, once the slot has gone to something else. Index 0
+// is never used, so a default handle is empty
+template <ResourceKind Kind>
+struct ResourceHandle {
+	unsigned int index = 0;
+	unsigned int generation = 0;
+
+	explicit operator bool() const { return index != 0; }
+};
+
+using TextureHandle = ResourceHandle<ResourceKind::texture>;
+using BufferHandle = ResourceHandle<ResourceKind::buffer>;
+
+// Owns the GL textures and buffers, counting references to each and the bytes
+// they take up. A resource whose last reference goes isn't deleted there and
+// then, as frames already submitted may still use it; it waits on a fence
+// where the driver has them, or a few frames where it doesn't, and collect()
+// deletes whatever's safe. Going over the budget doesn't refuse anything,
+// only warns, since there's nothing to evict. GL thread only, like the
+// context; the simulation thread deals in the plain ids from getId().
+class ResourceManager {
+public:
+	// Takes over a texture created elsewhere, e.g. by Texture's loaders, with
+	// the one reference belonging to the caller
+	static TextureHandle adoptTexture(unsigned int id, size_t bytes, const std::string& name);
+	static BufferHandle createBuffer(const std::string& name);
+
+	// Binds the buffer to target and gives it new storage, as glBufferData
+	static void bufferData(BufferHandle buffer, unsigned int target, size_t bytes, const void* data, unsigned int usage);
+
+	// 0 if the handle's been released
+	template <ResourceKind Kind>
+	static unsigned int getId(ResourceHandle<Kind> handle) {
+		const Resource* resource = find(Kind, handle.index, handle.generation);
+		return resource != nullptr ? resource->id : 0;
+	}
+
+	template <ResourceKind Kind>
+	static void acquire(ResourceHandle<Kind> handle) {
+		acquire(Kind, handle.index, handle.generation);
+	}
+
+	template <ResourceKind Kind>
+	static void release(ResourceHandle<Kind> handle) {
+		release(Kind, handle.index, handle.generation);
+	}
+
+	// Call once a frame, after it's been submitted
+	static void collect();
+	// Deletes everything released so far without waiting on the GPU, which
+	// must be finished with it, e.g. before the context is destroyed
+	static void flush();
+
+	static void setBudget(size_t bytes);
+	static size_t getBudget();
+	static size_t getResidentBytes(); // including released ones not yet deleted
+
+	// Every live resource, largest first, then the totals
+	static void report(std::ostream& out);
+
+private:
+	struct Resource {
+		ResourceKind kind = ResourceKind::texture;
+		unsigned int id = 0; // 0 while the slot's free
+		size_t bytes = 0;
+		unsigned int references = 0;
+		unsigned int generation = 0;
+		std::string name;
+	};
+
+	struct Released {
+		ResourceKind kind;
+		unsigned int id;
+		size_t bytes;
+		void* fence; // GLsync, or nullptr to count down frames instead
+		int frames;
+	};
+
+	static Resource* find(ResourceKind kind, unsigned int index, unsigned int generation);
+	static unsigned int add(ResourceKind kind, unsigned int id, size_t bytes, const std::string& name);
+	static void acquire(ResourceKind kind, unsigned int index, unsigned int generation);
+	static void release(ResourceKind kind, unsigned int index, unsigned int generation);
+	static void resize(Resource& resource, size_t bytes);
+	static void destroy(const Released& released);
+
+	inline static std::vector<Resource> resources = std::vector<Resource>(1); // [0] is the empty handle's
+	inline static std::vector<unsigned int> free_slots;
+	inline static std::vector<Released> released;
+
+	inline static size_t budget = GPU_MEMORY_BUDGET;
+	inline static size_t resident_bytes = 0;
+	inline static size_t peak_bytes = 0;
+	inline static bool over_budget = false;
+};
+
+#endif // I3D_RESOURCEMANAGER_H
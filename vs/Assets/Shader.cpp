@@ -0,0 +1,76 @@
+#include "Shader.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+unsigned int Shader::loadProgram(std::string vertex_filename, std::string fragment_filename,
+	const std::map<std::string, unsigned int>& attributes) {
+	if (!GLEW_VERSION_2_0) {
+		return 0;
+	}
+
+	unsigned int vertex = compile(GL_VERTEX_SHADER, vertex_filename);
+	unsigned int fragment = compile(GL_FRAGMENT_SHADER, fragment_filename);
+
+	if (vertex == 0 || fragment == 0) {
+		glDeleteShader(vertex);
+		glDeleteShader(fragment);
+		return 0;
+	}
+
+	unsigned int program = glCreateProgram();
+	glAttachShader(program, vertex);
+	glAttachShader(program, fragment);
+
+	for (const auto& attribute : attributes) {
+		glBindAttribLocation(program, attribute.second, attribute.first.c_str());
+	}
+
+	glLinkProgram(program);
+
+	// the program keeps the compiled stages alive for us
+	glDeleteShader(vertex);
+	glDeleteShader(fragment);
+
+	int linked;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (!linked) {
+		char log[1024];
+		glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+		std::cerr << "Shader: could not link " << vertex_filename << " + " << fragment_filename << std::endl << log;
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	return program;
+}
+
+unsigned int Shader::compile(GLenum type, std::string filename) {
+	std::ifstream file(filename);
+	if (!file) {
+		std::cerr << "Shader: could not open " << filename << std::endl;
+		return 0;
+	}
+
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	const std::string source = buffer.str();
+	const char* source_ptr = source.c_str();
+
+	unsigned int shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source_ptr, nullptr);
+	glCompileShader(shader);
+
+	int compiled;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (!compiled) {
+		char log[1024];
+		glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+		std::cerr << "Shader: could not compile " << filename << std::endl << log;
+		glDeleteShader(shader);
+		return 0;
+	}
+
+	return shader;
+}
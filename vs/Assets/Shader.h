@@ -0,0 +1,19 @@
+#ifndef I3D_SHADER_H
+#define I3D_SHADER_H
+
+#include "GlutHeaders.h"
+#include <string>
+#include <map>
+
+class Shader {
+public:
+	// Attributes are bound to the given locations before linking.
+	// Returns 0 if either stage fails to compile or the program fails to link
+	static unsigned int loadProgram(std::string vertex_filename, std::string fragment_filename,
+		const std::map<std::string, unsigned int>& attributes = {});
+
+private:
+	static unsigned int compile(GLenum type, std::string filename);
+};
+
+#endif // I3D_SHADER_H
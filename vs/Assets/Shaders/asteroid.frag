@@ -0,0 +1,11 @@
+#version 120
+#extension GL_EXT_texture_array : require
+
+uniform sampler2DArray textures;
+
+varying vec3 tex_coord;
+varying vec4 colour;
+
+void main() {
+	gl_FragColor = colour * texture2DArray(textures, tex_coord);
+}
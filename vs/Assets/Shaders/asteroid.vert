@@ -0,0 +1,53 @@
+#version 120
+
+// Instanced asteroid field. Every asteroid shares one unit sphere and is placed,
+// spun, scaled and lumped here from its per-instance attributes. Lighting mirrors
+// the fixed-function setup in GameManager::init (two lights, local viewer).
+
+// per vertex
+attribute vec3 vertex;     // unit sphere, so also the normal
+attribute vec2 uv;
+attribute float fudgeable; // 0 at the poles and seam so the sphere stays closed
+
+// per instance
+attribute mat4 model;      // translate * rotate * scale by radius
+attribute vec2 params;     // x = texture layer, y = shape seed
+
+uniform float fudge;       // ASTEROID_FUDGE
+
+varying vec3 tex_coord;
+varying vec4 colour;
+
+float hash(vec3 p) {
+	return fract(sin(dot(p, vec3(12.9898, 78.233, 37.719))) * 43758.5453);
+}
+
+void main() {
+	vec3 shape = vertex;
+	if (fudgeable > 0.5) {
+		shape.xz *= mix(1.0 - fudge, 1.0 + fudge, hash(vec3(uv, params.y)));
+	}
+
+	vec4 eye = gl_ModelViewMatrix * (model * vec4(shape, 1.0));
+
+	// uniform scale, so the model matrix can transform normals directly
+	vec3 n = normalize(gl_NormalMatrix * (mat3(model) * shape));
+	vec3 v = normalize(-eye.xyz);
+
+	vec4 c = gl_FrontLightModelProduct.sceneColor;
+	for (int i = 0; i < 2; ++i) {
+		vec3 l = gl_LightSource[i].position.w == 0.0
+			? normalize(gl_LightSource[i].position.xyz)
+			: normalize(gl_LightSource[i].position.xyz - eye.xyz);
+		float diffuse = max(dot(n, l), 0.0);
+
+		c += gl_FrontLightProduct[i].ambient + gl_FrontLightProduct[i].diffuse * diffuse;
+		if (diffuse > 0.0) {
+			c += gl_FrontLightProduct[i].specular * pow(max(dot(n, normalize(l + v)), 0.0), gl_FrontMaterial.shininess);
+		}
+	}
+
+	colour = vec4(clamp(c.rgb, 0.0, 1.0), gl_FrontMaterial.diffuse.a);
+	tex_coord = vec3(uv, params.x);
+	gl_Position = gl_ProjectionMatrix * eye;
+}
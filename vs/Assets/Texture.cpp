@@ -1,13 +1,12 @@
 #include "Texture.h"
 
-#define GL_CLAMP_TO_EDGE 0x812F
-
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 #include <iostream>
+#include <algorithm>
 
-uint32_t Texture::loadTexture(std::string filename, bool clamp) {
+TextureHandle Texture::loadTexture(std::string filename, bool clamp) {
     int width, height, components;
     stbi_set_flip_vertically_on_load(true);
     unsigned char* data = stbi_load(filename.c_str(), &width, &height, &components, STBI_rgb_alpha);
@@ -25,5 +24,83 @@ uint32_t Texture::loadTexture(std::string filename, bool clamp) {
     glPopAttrib();
     delete data;
     data = nullptr;
-    return id;
+    return ResourceManager::adoptTexture(id, static_cast<size_t>(width) * height * 4, filename);
+}
+
+// Packs same-sized images into the layers of a single 2D array texture so that
+// one bind covers every layer. Returns an empty handle if the driver has no array textures.
+TextureHandle Texture::loadTextureArray(const std::vector<std::string>& filenames, bool clamp) {
+    if (filenames.empty() || !(GLEW_VERSION_3_0 || GLEW_EXT_texture_array)) {
+        return {};
+    }
+
+    int width, height, components;
+    stbi_set_flip_vertically_on_load(true);
+
+    unsigned int id;
+    glPushAttrib(GL_TEXTURE_BIT);
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, clamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, clamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        for (size_t layer = 0; layer < filenames.size(); ++layer) {
+            unsigned char* data = stbi_load(filenames[layer].c_str(), &width, &height, &components, STBI_rgb_alpha);
+            if (layer == 0) {
+                // every layer shares the dimensions of the first image
+                glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, filenames.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            stbi_image_free(data);
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glPopAttrib();
+    return ResourceManager::adoptTexture(id, static_cast<size_t>(width) * height * 4 * filenames.size(),
+        filenames.front() + " (array of " + std::to_string(filenames.size()) + ")");
+}
+
+// Faces are given in GL order: +X, -X, +Y, -Y, +Z, -Z (right, left, top, bottom, back, front).
+// The cube map's per-face (s, t) conventions mean the side faces come out rotated 180
+// degrees compared to how the old six-quad skybox mapped them, so those are turned
+// back around on upload.
+TextureHandle Texture::loadCubeMap(const std::array<std::string, 6>& filenames) {
+    int width, height, components;
+    size_t bytes = 0;
+    stbi_set_flip_vertically_on_load(true);
+
+    unsigned int id;
+    glPushAttrib(GL_TEXTURE_BIT);
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        for (int face = 0; face < 6; ++face) {
+            unsigned char* data = stbi_load(filenames[face].c_str(), &width, &height, &components, STBI_rgb_alpha);
+            GLenum target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + face;
+
+            if (data != nullptr && target != GL_TEXTURE_CUBE_MAP_POSITIVE_Y && target != GL_TEXTURE_CUBE_MAP_NEGATIVE_Y) {
+                uint32_t* pixels = reinterpret_cast<uint32_t*>(data);
+                std::reverse(pixels, pixels + width * height);
+            }
+
+            glTexImage2D(target, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            stbi_image_free(data);
+            bytes += static_cast<size_t>(width) * height * 4;
+        }
+        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    glPopAttrib();
+
+    // Filter across face edges instead of clamping at each one, which is what
+    // otherwise shows up as visible seams along the cube's edges
+    if (GLEW_VERSION_3_2 || GLEW_ARB_seamless_cube_map) {
+        glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+    }
+
+    return ResourceManager::adoptTexture(id, bytes, filenames.front() + " (cube map)");
 }
\ No newline at end of file
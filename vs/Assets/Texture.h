@@ -2,11 +2,18 @@
 #define I3D_TEXTURE_H
 
 #include "GlutHeaders.h"
+#include "ResourceManager.h"
+
 #include <string>
+#include <array>
+#include <vector>
 
 class Texture {
 public:
-	static unsigned int loadTexture(std::string filename, bool clamp);
+	// Each is registered with the ResourceManager, the caller holding its reference
+	static TextureHandle loadTexture(std::string filename, bool clamp);
+	static TextureHandle loadTextureArray(const std::vector<std::string>& filenames, bool clamp);
+	static TextureHandle loadCubeMap(const std::array<std::string, 6>& filenames);
 	
 };
 
@@ -1,65 +1,43 @@
 #ifndef I3D_ASTEROID_H
 #define I3D_ASTEROID_H
 
+#include "ECS/World.h"
 #include "Math/Vector3D.h"
-#include "Math/Quaternion.h"
-#include <vector>
+#include "Render/RenderFrame.h"
+#include "State/WorldState.h"
 
-class Asteroid {
-public:
-	Asteroid(Vector3D position, Vector3D velocity, unsigned int texture);
-	void buildVertices();
-	void draw();
-	void update(const float dt);
-	void checkIfInArena(const float arena_dimension);
+#include <random>
 
-	void decrementHealthBy(int num);
-	void markForDeletion();
-	bool isMarkedForDeletion() const;
-
-	void reverseX();
-	void reverseY();
-	void reverseZ();
-
-	const unsigned int id() const;
-	const Vector3D& getPosition() const;
-	const Vector3D& getVelocity() const;
-	const int getHealth() const;
-	void setVelocity(const Vector3D& velocity);
-	const float getRadius() const;
-	const float getMass() const;
-	const bool isInArena() const;
-
-private:
-	static unsigned int nextID();
-	void addVertex(float x, float y, float z);
-	void addUV(float u, float v);
-	void addNormal(float nx, float ny, float nz);
-	void addIndices(unsigned int i1, unsigned int i2, unsigned int i3);
-
-	unsigned int asteroid_id;
-	Vector3D position;
-	Vector3D velocity;
-
-	bool inArena;
-
-	unsigned int texture;
+// Marks the entities that are asteroids, and holds what only they have.
+// Besides this they have a Position and Velocity, which systems::integrate
+// moves them by along with everything else
+struct Asteroid {
 	float radius;
 	float mass;
+	int health;
+	bool in_arena;
+	int texture_layer; // index of texture within Entity::asteroid_array
+	float seed; // picks the asteroid's lumpy shape
 	Vector3D rotation_axis;
 	float angle;
 	float rotation_speed;
 	int rotation_direction;
-	int health;
-	bool to_delete;
+};
 
-	int sectors;
-	int stacks;
+namespace asteroid {
+	// Rolls its texture, shape, size and spin from rng. Only data, so a wave
+	// can be rolled off the simulation thread and created on it
+	Asteroid roll(std::mt19937& rng);
 
-	std::vector<float> vertices;
-	std::vector<float> uvs;
-	std::vector<float> normals;
-	std::vector<unsigned int> indices;
-};
+	ecs::EntityId create(ecs::World& world, const Asteroid& asteroid, const Vector3D& position, const Vector3D& velocity);
+
+	// From a state stream
+	ecs::EntityId create(ecs::World& world, const EntityState& state);
+
+	// Spins every asteroid, and notes the ones that have made it into the arena
+	void update(ecs::World& world, float dt);
+
+	void record(ecs::World& world, RenderFrame& frame);
+}
 
-#endif // I3D_ASTEROID_H
\ No newline at end of file
+#endif // I3D_ASTEROID_H
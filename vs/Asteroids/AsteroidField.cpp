@@ -3,44 +3,82 @@
 #include "Constants/AsteroidConstants.h"
 #include "Constants/ArenaConstants.h"
 
-#include "Assets/Asset.h"
-#include <algorithm>
-
 AsteroidField::AsteroidField() :
 	arena_radius(sqrt(3) * ARENA_DIM),
 	asteroid_count(1),
 	timer(0),
 	time_between_levels(45),
-	levelling_up(false) {
-	textures.push_back(Asset::getTextureId(Entity::asteroid_1));
-	textures.push_back(Asset::getTextureId(Entity::asteroid_2));
-	textures.push_back(Asset::getTextureId(Entity::asteroid_3));
-	textures.push_back(Asset::getTextureId(Entity::asteroid_4));
-}
+	levelling_up(false),
+	next_wave_count(0),
+	next_wave_seed(0) {}
 
-void AsteroidField::launchAsteroidsAtShip(Vector3D ship_position) {
-	for (int i = 0; i < asteroid_count; ++i) {
-		float speed = utility::randFloat(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED);
-		Vector3D asteroid_position = Vector3D::randomUnit() * arena_radius;
-		Vector3D asteroid_velocity = speed * Vector3D::normalise(ship_position - asteroid_position);
-		asteroids.emplace_back(asteroid_position, asteroid_velocity, textures[utility::randInt(0, textures.size() - 1)]);
+void AsteroidField::launchAsteroidsAtShip(ecs::World& world, Vector3D ship_position) {
+	const int count = static_cast<int>(asteroid_count);
+	const Wave wave = takeWave(count);
+	for (int i = 0; i < count; ++i) {
+		const Vector3D& position = wave.positions[i];
+		asteroid::create(world, wave.asteroids[i], position, wave.speeds[i] * Vector3D::normalise(ship_position - position));
 	}
 	levelling_up = false;
+
+	// GameManager adds one asteroid per wave
+	prepareWave(count + 1);
+}
+
+// The worker gets its own engine, seeded from the shared one here on the
+// simulation thread, so a recorded session still replays the same waves
+void AsteroidField::prepareWave(int count) {
+	next_wave_count = count;
+	next_wave_seed = utility::engine();
+	next_wave = std::async(std::launch::async, &AsteroidField::buildWave, this, count, next_wave_seed);
+}
+
+// Usually long finished by the time its wave is due. A field cleared early
+// can want it sooner, and a reset can make it the wrong size, in which case
+// it's thrown away and the wave built here instead. Either way the asteroids
+// only become entities once launched, so their ids don't depend on when the
+// worker ran
+AsteroidField::Wave AsteroidField::takeWave(int count) {
+	next_wave_count = 0;
+	Wave wave;
+	bool ready = false;
+	if (next_wave.valid()) {
+		wave = next_wave.get();
+		ready = wave.count == count;
+	}
+	if (!ready) {
+		wave = buildWave(count, utility::engine());
+	}
+	return wave;
 }
 
-void AsteroidField::updateAsteroids(float dt) {
-	for (auto i = 0; i < asteroids.size(); ++i) {
-		asteroids[i].update(dt);
+AsteroidField::Wave AsteroidField::buildWave(int count, unsigned int seed) const {
+	std::mt19937 rng(seed);
 
-		if (!asteroids[i].isInArena()) {
-			asteroids[i].checkIfInArena(ARENA_DIM - 0.5);
-		}
+	Wave wave;
+	wave.count = count;
+	wave.asteroids.reserve(count);
+	wave.positions.reserve(count);
+	wave.speeds.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		wave.speeds.push_back(utility::randFloat(rng, ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED));
+		wave.positions.push_back(Vector3D::randomUnit(rng) * arena_radius);
+		wave.asteroids.push_back(asteroid::roll(rng));
+	}
+	return wave;
+}
 
-		if (asteroids[i].isMarkedForDeletion()) {
-			deleteAsteroidByIndex(i);
-		}
+// From random points on the arena's bounding sphere, independent of the waves
+void AsteroidField::launchAsteroidsAt(ecs::World& world, Vector3D target, int count) {
+	for (int i = 0; i < count; ++i) {
+		float speed = utility::randFloat(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED);
+		Vector3D asteroid_position = Vector3D::randomUnit() * arena_radius;
+		Vector3D asteroid_velocity = speed * Vector3D::normalise(target - asteroid_position);
+		asteroid::create(world, asteroid::roll(utility::engine), asteroid_position, asteroid_velocity);
 	}
+}
 
+void AsteroidField::update(float dt) {
 	if (timer < time_between_levels) {
 		timer += dt;
 	}
@@ -50,16 +88,6 @@ void AsteroidField::updateAsteroids(float dt) {
 	}
 }
 
-void AsteroidField::drawAsteroids() {
-	for (Asteroid& asteroid : asteroids) {
-		asteroid.draw();
-	}
-}
-
-bool AsteroidField::isEmpty() const {
-	return asteroids.empty();
-}
-
 bool AsteroidField::levellingUp() const {
 	return levelling_up;
 }
@@ -72,18 +100,52 @@ void AsteroidField::resetTimer() {
 	timer = 0;
 }
 
-void AsteroidField::deleteAsteroidByIndex(unsigned int index) {
-	std::swap(asteroids[index], asteroids.back());
-	asteroids.pop_back();
-}
-
-std::vector<Asteroid>& AsteroidField::getAsteroids() {
-	return asteroids;
-}
-
 void AsteroidField::reset() {
 	asteroid_count = 0;
 	resetTimer();
-	asteroids.clear();
 	levelling_up = false;
-}
\ No newline at end of file
+}
+
+void AsteroidField::save(Snapshot& snapshot) const {
+	snapshot.write(asteroid_count);
+	snapshot.write(timer);
+	snapshot.write(time_between_levels);
+	snapshot.write(levelling_up);
+	snapshot.write(next_wave_count);
+	snapshot.write(next_wave_seed);
+}
+
+void AsteroidField::restore(Snapshot::Reader& reader) {
+	reader.read(asteroid_count);
+	reader.read(timer);
+	reader.read(time_between_levels);
+	reader.read(levelling_up);
+
+	int count;
+	unsigned int seed;
+	reader.read(count);
+	reader.read(seed);
+	if (count == next_wave_count && seed == next_wave_seed) {
+		return;
+	}
+
+	// Waits for the worker if it's still on the one being replaced
+	next_wave_count = count;
+	next_wave_seed = seed;
+	if (count > 0) {
+		next_wave = std::async(std::launch::async, &AsteroidField::buildWave, this, count, seed);
+	}
+	else {
+		next_wave = {};
+	}
+}
+
+void AsteroidField::captureState(WorldState& state) const {
+	state.asteroid_count = asteroid_count;
+	state.level_timer = timer;
+}
+
+void AsteroidField::applyState(const WorldState& state) {
+	asteroid_count = state.asteroid_count;
+	timer = state.level_timer;
+}
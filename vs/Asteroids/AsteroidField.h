@@ -2,35 +2,68 @@
 #define I3D_ASTEROIDFIELD_H
 
 #include "Asteroids/Asteroid.h"
+#include "ECS/World.h"
 #include "Math/Vector3D.h"
+#include "State/Snapshot.h"
+#include "State/WorldState.h"
 
+#include <future>
 #include <vector>
 
+// Sends the asteroids in, wave by wave; once launched they're entities in
+// the world like anything else. Each wave is built on a worker thread while
+// the level timer counts down to it, so launching it is only aiming the
+// asteroids and creating them
 class AsteroidField {
 public:
 	AsteroidField();
 
-	void launchAsteroidsAtShip(Vector3D ship_position);
-	void updateAsteroids(float dt);
-	void drawAsteroids();
-	bool isEmpty() const;
+	// Launches the next wave, then starts building the one after
+	void launchAsteroidsAtShip(ecs::World& world, Vector3D ship_position);
+	void launchAsteroidsAt(ecs::World& world, Vector3D target, int count);
+	void update(float dt); // the level timer
 	bool levellingUp() const;
 	void increaseAsteroidCountBy(int counter);
 	void resetTimer();
-	void deleteAsteroidByIndex(unsigned int index);
-	std::vector<Asteroid>& getAsteroids();
-	
+
 	void reset();
 
+	// The level timer and the wave being built. The wave goes in as the seed
+	// it's built from, and is rebuilt from that on restore unless it's the one
+	// already underway. The asteroids themselves are saved with the world
+	void save(Snapshot& snapshot) const;
+	void restore(Snapshot::Reader& reader);
+
+	// The level timer, for the state stream. Applying a state leaves the wave
+	// underway alone
+	void captureState(WorldState& state) const;
+	void applyState(const WorldState& state);
+
 private:
-	std::vector<unsigned int> textures;
+	// Everything about a wave that doesn't depend on where the ship is when
+	// it fires; the velocities are filled in from the speeds at launch
+	struct Wave {
+		int count = 0;
+		std::vector<Asteroid> asteroids;
+		std::vector<Vector3D> positions;
+		std::vector<float> speeds;
+	};
+
+	void prepareWave(int count);
+	Wave takeWave(int count);
+	Wave buildWave(int count, unsigned int seed) const;
+
 	float arena_radius;
 	float asteroid_count;
 	float timer;
 	float time_between_levels;
 	bool levelling_up;
 
-	std::vector<Asteroid> asteroids;
+	int next_wave_count; // 0 when there's no wave underway
+	unsigned int next_wave_seed;
+
+	// Last, so it's waited on before anything the worker reads is destroyed
+	std::future<Wave> next_wave;
 };
 
 #endif // I3D_ASTEROIDFIELD_H
\ No newline at end of file
@@ -0,0 +1,283 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "AsteroidRenderer.h"
+#include "GlutHeaders.h"
+
+#include "Assets/Asset.h"
+#include "Assets/Shader.h"
+#include "Assets/ResourceManager.h"
+#include "Assets/Texture.h"
+#include "Constants/AsteroidConstants.h"
+#include "Constants/RenderConstants.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// Generic attribute locations, bound before the program is linked
+enum AsteroidAttribute {
+	VERTEX = 0,
+	UV = 1,
+	FUDGEABLE = 2,
+	MODEL = 3, // a mat4 takes up 3, 4, 5 and 6
+	PARAMS = 7
+};
+
+AsteroidRenderer::AsteroidRenderer()
+	: instanced(false)
+	, program(0)
+	, texture_array(0)
+	, vertex_buffer()
+	, index_buffer()
+	, instance_buffer()
+	, textures_location(-1)
+	, fudge_location(-1) {
+	buildIndices();
+	instanced = initInstancing();
+
+	if (!instanced) {
+		shapes.resize(ASTEROID_SHAPE_COUNT);
+		for (std::vector<float>& shape : shapes) {
+			buildSphere(true, shape);
+		}
+		for (const char* filename : ASTEROID_TEXTURES) {
+			layer_textures.push_back(Texture::loadTexture(filename, false));
+		}
+	}
+}
+
+AsteroidRenderer::~AsteroidRenderer() {
+	if (!instanced) {
+		for (TextureHandle texture : layer_textures) {
+			ResourceManager::release(texture);
+		}
+		return;
+	}
+	ResourceManager::release(vertex_buffer);
+	ResourceManager::release(index_buffer);
+	ResourceManager::release(instance_buffer);
+	glDeleteProgram(program);
+}
+
+bool AsteroidRenderer::isInstanced() const {
+	return instanced;
+}
+
+size_t AsteroidRenderer::getTrianglesPerAsteroid() const {
+	return indices.size() / 3;
+}
+
+bool AsteroidRenderer::initInstancing() {
+	// glDrawElementsInstanced is 3.1, glVertexAttribDivisor is 3.3
+	if (!GLEW_VERSION_3_3) {
+		return false;
+	}
+
+	texture_array = Asset::getTextureId(Entity::asteroid_array);
+	if (texture_array == 0) {
+		return false;
+	}
+
+	program = Shader::loadProgram("./Assets/Shaders/asteroid.vert", "./Assets/Shaders/asteroid.frag",
+		{ { "vertex", VERTEX }, { "uv", UV }, { "fudgeable", FUDGEABLE }, { "model", MODEL }, { "params", PARAMS } });
+	if (program == 0) {
+		return false;
+	}
+
+	textures_location = glGetUniformLocation(program, "textures");
+	fudge_location = glGetUniformLocation(program, "fudge");
+
+	// The fudge is applied per instance in the vertex shader, so upload a
+	// smooth sphere, with a flag per vertex for whether it may be fudged
+	std::vector<float> vertices;
+	buildSphere(false, vertices);
+
+	vertex_buffer = ResourceManager::createBuffer("asteroid sphere vertices");
+	ResourceManager::bufferData(vertex_buffer, GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+	index_buffer = ResourceManager::createBuffer("asteroid sphere indices");
+	ResourceManager::bufferData(index_buffer, GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+	instance_buffer = ResourceManager::createBuffer("asteroid instances");
+	instances.reserve(RENDER_FRAME_ASTEROIDS);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	return true;
+}
+
+// Either a lumpy sphere interleaved as x y z u v (fudge), or a smooth one
+// interleaved as x y z u v fudgeable for the shader to lump up itself.
+// Either way it's a unit sphere, so normals = verts
+void AsteroidRenderer::buildSphere(bool fudge, std::vector<float>& vertices) {
+	const float pi = acos(-1);
+	const int sectors = ASTEROID_SECTOR_COUNT;
+	const int stacks = ASTEROID_STACK_COUNT;
+
+	float sector_step = 2 * pi / sectors; // THETA STEP
+	float stack_step = pi / stacks; // PHI STEP
+
+	// adds sector# of vertices at poles
+	for (int i = 0; i <= stacks; ++i) {
+		float phi = pi / 2 - i * stack_step;
+		for (int j = 0; j <= sectors; ++j) {
+			float theta = j * sector_step;
+			float x = sin(theta) * cos(phi);
+			float y = sin(phi);
+			float z = cos(theta) * cos(phi);
+
+			// Make sure we're not fudging the poles
+			bool fudgeable = j > 0 && j < stacks && i > 0 && i < sectors;
+
+			if (fudge && fudgeable) {
+				float amount = std::uniform_real_distribution<float>(1 - ASTEROID_FUDGE, 1 + ASTEROID_FUDGE)(shape_engine);
+				x *= amount;
+				z *= amount;
+			}
+
+			vertices.insert(vertices.end(), { x, y, z, (float)j / sectors, (float)i / sectors });
+			if (!fudge) {
+				vertices.push_back(fudgeable ? 1.0f : 0.0f);
+			}
+		}
+	}
+}
+
+void AsteroidRenderer::buildIndices() {
+	const int sectors = ASTEROID_SECTOR_COUNT;
+	const int stacks = ASTEROID_STACK_COUNT;
+
+	unsigned int k1, k2;
+	for (int i = 0; i < stacks; ++i) {
+		k1 = i * (sectors + 1);
+		k2 = k1 + sectors + 1;
+
+		for (int j = 0; j < sectors; ++j, ++k1, ++k2) {
+			// two triangles per face excluding first and last stacks
+			if (i != 0) {
+				indices.insert(indices.end(), { k1, k2, k1 + 1 });
+			}
+
+			// k1+1 => k2 => k2+1
+			if (i != (stacks - 1)) {
+				indices.insert(indices.end(), { k1 + 1, k2, k2 + 1 });
+			}
+		}
+	}
+}
+
+void AsteroidRenderer::begin() {
+	glEnable(GL_LIGHTING);
+	glColor3f(1.0, 1.0, 1.0);
+
+	// In the instanced path the shader reads these back through gl_FrontMaterial
+	float ambient[] = { 1.0, 1.0, 1.0, 1.0 };
+	float diffuse[] = { 1.0, 1.0, 1.0, 1.0 };
+	float specular[] = { 1.0, 1.0, 1.0, 1.0 };
+	glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
+	glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
+	glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
+	glMaterialf(GL_FRONT, GL_SHININESS, 128);
+
+	if (instanced) {
+		instances.clear();
+		return;
+	}
+
+	glEnable(GL_TEXTURE_2D);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_NORMAL_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+
+// params = { texture layer, shape seed }
+void AsteroidRenderer::add(const RenderCommand& command) {
+	if (instanced) {
+		AsteroidInstance instance;
+		std::copy(command.transform.begin(), command.transform.end(), instance.transform);
+		instance.layer = command.params[0];
+		instance.seed = command.params[1];
+		instances.push_back(instance);
+		return;
+	}
+
+	int shape = std::min(static_cast<int>(command.params[1] * shapes.size()), static_cast<int>(shapes.size()) - 1);
+	const std::vector<float>& vertices = shapes[shape];
+	int layer = std::clamp(static_cast<int>(command.params[0]), 0, static_cast<int>(layer_textures.size()) - 1);
+	const GLsizei stride = 5 * sizeof(float);
+
+	glPushMatrix();
+		glMultMatrixf(command.transform.data());
+		glBindTexture(GL_TEXTURE_2D, ResourceManager::getId(layer_textures[layer]));
+
+		glTexCoordPointer(2, GL_FLOAT, stride, &vertices[3]);
+		glNormalPointer(GL_FLOAT, stride, &vertices[0]);
+		glVertexPointer(3, GL_FLOAT, stride, &vertices[0]);
+
+		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, &indices[0]);
+	glPopMatrix();
+}
+
+void AsteroidRenderer::end() {
+	if (!instanced) {
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisableClientState(GL_NORMAL_ARRAY);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisable(GL_TEXTURE_2D);
+		glDisable(GL_LIGHTING);
+		return;
+	}
+
+	if (instances.empty()) {
+		glDisable(GL_LIGHTING);
+		return;
+	}
+
+	glUseProgram(program);
+	glUniform1i(textures_location, 0);
+	glUniform1f(fudge_location, ASTEROID_FUDGE);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture_array);
+
+	// shared sphere
+	const GLsizei stride = 6 * sizeof(float);
+	glBindBuffer(GL_ARRAY_BUFFER, ResourceManager::getId(vertex_buffer));
+	glEnableVertexAttribArray(VERTEX);
+	glEnableVertexAttribArray(UV);
+	glEnableVertexAttribArray(FUDGEABLE);
+	glVertexAttribPointer(VERTEX, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	glVertexAttribPointer(UV, 2, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+	glVertexAttribPointer(FUDGEABLE, 1, GL_FLOAT, GL_FALSE, stride, (void*)(5 * sizeof(float)));
+
+	// Stream this frame's instances, orphaning last frame's storage so we never
+	// wait on the driver to finish with it
+	const GLsizeiptr size = instances.size() * sizeof(AsteroidInstance);
+	ResourceManager::bufferData(instance_buffer, GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, instances.data());
+
+	for (int column = 0; column < 4; ++column) {
+		glEnableVertexAttribArray(MODEL + column);
+		glVertexAttribPointer(MODEL + column, 4, GL_FLOAT, GL_FALSE, sizeof(AsteroidInstance),
+			(void*)(offsetof(AsteroidInstance, transform) + column * 4 * sizeof(float)));
+		glVertexAttribDivisor(MODEL + column, 1);
+	}
+	glEnableVertexAttribArray(PARAMS);
+	glVertexAttribPointer(PARAMS, 2, GL_FLOAT, GL_FALSE, sizeof(AsteroidInstance), (void*)offsetof(AsteroidInstance, layer));
+	glVertexAttribDivisor(PARAMS, 1);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ResourceManager::getId(index_buffer));
+	glDrawElementsInstanced(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, (void*)0, instances.size());
+
+	// leave everything as the fixed function path expects it
+	for (int attribute = VERTEX; attribute <= PARAMS; ++attribute) {
+		glVertexAttribDivisor(attribute, 0);
+		glDisableVertexAttribArray(attribute);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	glUseProgram(0);
+	glDisable(GL_LIGHTING);
+}
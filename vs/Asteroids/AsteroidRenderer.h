@@ -0,0 +1,64 @@
+#ifndef I3D_ASTEROIDRENDERER_H
+#define I3D_ASTEROIDRENDERER_H
+
+#include "Render/RenderCommand.h"
+#include "Assets/ResourceManager.h"
+
+#include <random>
+#include <vector>
+
+// Render side of the asteroid field. The unit sphere is uploaded once and the
+// asteroid commands between begin() and end() are drawn with a single instanced
+// call, each contributing only a small per-instance record. Without instancing
+// support each asteroid is drawn on its own, using one of a fixed set of
+// lumpy spheres built up front and a 2D texture per layer loaded only then,
+// so nothing here depends on the Asteroid objects.
+
+struct AsteroidInstance {
+	float transform[16];
+	float layer;
+	float seed;
+};
+
+class AsteroidRenderer {
+public:
+	AsteroidRenderer();
+	~AsteroidRenderer();
+
+	AsteroidRenderer(const AsteroidRenderer&) = delete;
+	AsteroidRenderer& operator=(const AsteroidRenderer&) = delete;
+
+	bool isInstanced() const;
+	size_t getTrianglesPerAsteroid() const;
+
+	void begin();
+	void add(const RenderCommand& command);
+	void end();
+
+private:
+	void buildSphere(bool fudge, std::vector<float>& vertices);
+	void buildIndices();
+	bool initInstancing();
+
+	bool instanced;
+
+	std::vector<unsigned int> indices;
+
+	// instanced path
+	unsigned int program;
+	unsigned int texture_array;
+	BufferHandle vertex_buffer;
+	BufferHandle index_buffer;
+	BufferHandle instance_buffer;
+	int textures_location;
+	int fudge_location;
+	std::vector<AsteroidInstance> instances; // reused every frame
+
+	// fallback path, interleaved x y z u v. The shapes get their own engine so
+	// which path we're on never shifts the gameplay random sequence
+	std::vector<std::vector<float>> shapes;
+	std::mt19937 shape_engine;
+	std::vector<TextureHandle> layer_textures; // by texture layer
+};
+
+#endif // I3D_ASTEROIDRENDERER_H
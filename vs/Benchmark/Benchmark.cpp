@@ -0,0 +1,396 @@
+#include "Benchmark.h"
+#include "GameManager.h"
+
+#include "Constants/BenchmarkConstants.h"
+#include "Constants/RenderConstants.h"
+#include "Math/Utility.h"
+#include "Profiling/Profiler.h"
+#include "Profiling/AllocationTracker.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace {
+	// Just enough JSON to read back what writeJson produces: nested objects
+	// whose leaves are numbers, flattened to "scenario.phases.update.p95" -> value
+	class JsonReader {
+	public:
+		explicit JsonReader(const std::string& text) : text(text), at(0) {}
+
+		bool parse(std::map<std::string, double>& values) {
+			return parseValue("", values) && (skipSpace(), at == text.size());
+		}
+
+	private:
+		void skipSpace() {
+			while (at < text.size() && std::isspace(static_cast<unsigned char>(text[at]))) {
+				++at;
+			}
+		}
+
+		bool parseString(std::string& out) {
+			skipSpace();
+			if (at >= text.size() || text[at] != '"') {
+				return false;
+			}
+			size_t end = text.find('"', ++at);
+			if (end == std::string::npos) {
+				return false;
+			}
+			out = text.substr(at, end - at);
+			at = end + 1;
+			return true;
+		}
+
+		bool parseValue(const std::string& path, std::map<std::string, double>& values) {
+			skipSpace();
+			if (at >= text.size()) {
+				return false;
+			}
+
+			if (text[at] != '{') {
+				size_t length = 0;
+				try {
+					values[path] = std::stod(text.substr(at), &length);
+				}
+				catch (const std::exception&) {
+					return false;
+				}
+				at += length;
+				return true;
+			}
+
+			++at;
+			skipSpace();
+			if (at < text.size() && text[at] == '}') {
+				++at;
+				return true;
+			}
+
+			while (true) {
+				std::string key;
+				if (!parseString(key)) {
+					return false;
+				}
+				skipSpace();
+				if (at >= text.size() || text[at++] != ':') {
+					return false;
+				}
+				if (!parseValue(path.empty() ? key : path + "." + key, values)) {
+					return false;
+				}
+				skipSpace();
+				if (at < text.size() && text[at] == ',') {
+					++at;
+					continue;
+				}
+				if (at < text.size() && text[at] == '}') {
+					++at;
+					return true;
+				}
+				return false;
+			}
+		}
+
+		const std::string& text;
+		size_t at;
+	};
+
+	const char* STAT_NAMES[] = { "mean", "p50", "p95", "p99" };
+
+	double stat(const PhaseStats& stats, int index) {
+		const double values[] = { stats.mean, stats.p50, stats.p95, stats.p99 };
+		return values[index];
+	}
+}
+
+Benchmark::Benchmark(bool render, int width, int height)
+	: render(render)
+	, strict(false)
+	, occlusion_culling(OCCLUSION_CULLING)
+	, width(width)
+	, height(height) {}
+
+void Benchmark::trackAllocations(bool strict) {
+	AllocationTracker::setEnabled(true);
+	this->strict = strict;
+}
+
+void Benchmark::setOcclusionCulling(bool setting) {
+	occlusion_culling = setting;
+}
+
+void Benchmark::setStartingState(const WorldState& state) {
+	starting_state = std::make_unique<WorldState>(state);
+}
+
+// Each run gets a fresh game on a single thread, so the phases are measured
+// back to back rather than overlapping
+ScenarioResult Benchmark::run(const Scenario& scenario) const {
+	utility::seed(BENCHMARK_SEED);
+
+	GameManager game;
+	prepare(game);
+	if (starting_state) {
+		game.applyState(*starting_state);
+	}
+
+	if (scenario.setup) {
+		scenario.setup(game);
+	}
+
+	Profiler::setEnabled(false);
+	Profiler::reset();
+
+	for (int tick = 0; tick < BENCHMARK_WARMUP_TICKS + scenario.ticks; ++tick) {
+		if (tick == BENCHMARK_WARMUP_TICKS) {
+			Profiler::setEnabled(true);
+			AllocationTracker::resetViolations();
+			AllocationTracker::setStrict(strict);
+		}
+		if (scenario.step) {
+			scenario.step(game, tick);
+		}
+		step(game);
+	}
+	Profiler::setEnabled(false);
+	AllocationTracker::setStrict(false);
+
+	return collect(scenario.name, scenario.ticks);
+}
+
+std::vector<ScenarioResult> Benchmark::stress(int population, int spawn_rate) const {
+	utility::seed(BENCHMARK_SEED);
+
+	GameManager game;
+	prepare(game);
+	game.setShipInvulnerable(true); // otherwise the first hit wipes the whole field
+
+	AsteroidField& field = game.getAsteroidField();
+	ecs::World& world = game.getWorld();
+	auto topUp = [&field, &world, spawn_rate](int target) {
+		const int missing = target - static_cast<int>(world.count<Asteroid>());
+		if (missing > 0) {
+			field.launchAsteroidsAt(world, Vector3D(), std::min(missing, spawn_rate));
+		}
+	};
+
+	std::vector<ScenarioResult> results;
+	int checkpoint = std::min(STRESS_FIRST_POPULATION, population);
+	while (true) {
+		Profiler::setEnabled(false);
+		while (static_cast<int>(world.count<Asteroid>()) < checkpoint) {
+			topUp(checkpoint);
+			step(game);
+		}
+
+		// Bullets never fly here, but the field is still topped up in case
+		// anything does get destroyed, so the population holds while timed
+		Profiler::reset();
+		Profiler::setEnabled(true);
+		AllocationTracker::resetViolations();
+		for (int tick = 0; tick < STRESS_SAMPLE_TICKS; ++tick) {
+			topUp(checkpoint);
+			step(game);
+		}
+		Profiler::setEnabled(false);
+
+		results.push_back(collect("stress-" + std::to_string(checkpoint), STRESS_SAMPLE_TICKS));
+		std::cerr << checkpoint << " asteroids: " << results.back().phases["tick"].mean << " ms/tick" << std::endl;
+
+		if (checkpoint >= population) {
+			break;
+		}
+		if (results.back().phases["tick"].mean > STRESS_TICK_BUDGET) {
+			std::cerr << "Over the " << STRESS_TICK_BUDGET << " ms tick budget, stopping" << std::endl;
+			break;
+		}
+		checkpoint = std::min(checkpoint * 2, population);
+	}
+	return results;
+}
+
+void Benchmark::prepare(GameManager& game) const {
+	game.setThreaded(false);
+	game.setHeadless(true);
+	game.setFixedTimeStep(BENCHMARK_DT);
+	game.setOcclusionCulling(occlusion_culling);
+	game.init();
+	game.onReshape(width, height);
+}
+
+void Benchmark::step(GameManager& game) const {
+	game.tick();
+	if (render) {
+		game.onDisplay();
+	}
+}
+
+ScenarioResult Benchmark::collect(const std::string& name, int ticks) {
+	auto mean = [](const std::vector<double>& samples) {
+		return samples.empty() ? 0.0 : std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+	};
+
+	ScenarioResult result;
+	result.name = name;
+	result.ticks = ticks;
+	result.steady_state_violations = AllocationTracker::getViolations();
+	for (int phase = 0; phase < static_cast<int>(Phase::count); ++phase) {
+		const std::vector<double>& samples = Profiler::getSamples(static_cast<Phase>(phase));
+		if (samples.empty()) {
+			continue;
+		}
+
+		PhaseStats stats = summarise(samples);
+		stats.allocations = mean(Profiler::getAllocations(static_cast<Phase>(phase)));
+		stats.bytes = mean(Profiler::getAllocatedBytes(static_cast<Phase>(phase)));
+		result.phases[Profiler::getName(static_cast<Phase>(phase))] = stats;
+	}
+	return result;
+}
+
+// Nearest-rank percentiles
+PhaseStats Benchmark::summarise(std::vector<double> samples) {
+	if (samples.empty()) {
+		return { 0, 0, 0, 0, 0, 0 };
+	}
+
+	std::sort(samples.begin(), samples.end());
+	auto percentile = [&samples](double p) {
+		size_t rank = static_cast<size_t>(std::ceil(p / 100 * samples.size()));
+		return samples[std::max<size_t>(rank, 1) - 1];
+	};
+
+	const double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+	return { mean, percentile(50), percentile(95), percentile(99), 0, 0 };
+}
+
+void Benchmark::writeJson(std::ostream& out, const std::vector<ScenarioResult>& results) {
+	out << std::fixed << std::setprecision(6);
+	out << "{\n";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const ScenarioResult& result = results[i];
+		out << "  \"" << result.name << "\": {\n";
+		out << "    \"ticks\": " << result.ticks << ",\n";
+		if (AllocationTracker::isEnabled()) {
+			out << "    \"steady_state_violations\": " << result.steady_state_violations << ",\n";
+		}
+		out << "    \"phases\": {\n";
+
+		size_t phase = 0;
+		for (const auto& entry : result.phases) {
+			const PhaseStats& stats = entry.second;
+			out << "      \"" << entry.first << "\": { "
+				<< "\"mean\": " << stats.mean << ", "
+				<< "\"p50\": " << stats.p50 << ", "
+				<< "\"p95\": " << stats.p95 << ", "
+				<< "\"p99\": " << stats.p99;
+			if (AllocationTracker::isEnabled()) {
+				out << ", \"allocations\": " << stats.allocations << ", \"bytes\": " << stats.bytes;
+			}
+			out << " }"
+				<< (++phase < result.phases.size() ? "," : "") << "\n";
+		}
+
+		out << "    }\n";
+		out << "  }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	out << "}" << std::endl;
+}
+
+bool Benchmark::readJson(const std::string& filename, std::vector<ScenarioResult>& results) {
+	std::ifstream file(filename);
+	if (!file) {
+		std::cerr << "Failed to open " << filename << std::endl;
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	const std::string text = buffer.str();
+
+	std::map<std::string, double> values;
+	if (!JsonReader(text).parse(values)) {
+		std::cerr << filename << " is not a benchmark result" << std::endl;
+		return false;
+	}
+
+	// "<scenario>.ticks" and "<scenario>.phases.<phase>.<stat>"
+	std::map<std::string, ScenarioResult> scenarios;
+	for (const auto& entry : values) {
+		const std::string& path = entry.first;
+		const size_t first = path.find('.');
+		if (first == std::string::npos) {
+			continue;
+		}
+
+		ScenarioResult& result = scenarios[path.substr(0, first)];
+		result.name = path.substr(0, first);
+
+		const std::string rest = path.substr(first + 1);
+		if (rest == "ticks") {
+			result.ticks = static_cast<int>(entry.second);
+			continue;
+		}
+		if (rest == "steady_state_violations") {
+			result.steady_state_violations = static_cast<std::uint64_t>(entry.second);
+			continue;
+		}
+
+		const std::string prefix = "phases.";
+		const size_t last = rest.rfind('.');
+		if (rest.compare(0, prefix.size(), prefix) != 0 || last == std::string::npos || last < prefix.size()) {
+			continue;
+		}
+
+		PhaseStats& stats = result.phases[rest.substr(prefix.size(), last - prefix.size())];
+		const std::string name = rest.substr(last + 1);
+		if (name == "mean") stats.mean = entry.second;
+		else if (name == "p50") stats.p50 = entry.second;
+		else if (name == "p95") stats.p95 = entry.second;
+		else if (name == "p99") stats.p99 = entry.second;
+		else if (name == "allocations") stats.allocations = entry.second;
+		else if (name == "bytes") stats.bytes = entry.second;
+	}
+
+	for (auto& entry : scenarios) {
+		results.push_back(entry.second);
+	}
+	return true;
+}
+
+bool Benchmark::compare(const std::vector<ScenarioResult>& baseline, const std::vector<ScenarioResult>& results,
+	float threshold) {
+	bool passed = true;
+
+	for (const ScenarioResult& result : results) {
+		auto before = std::find_if(baseline.begin(), baseline.end(),
+			[&result](const ScenarioResult& other) { return other.name == result.name; });
+		if (before == baseline.end()) {
+			continue;
+		}
+
+		for (const auto& entry : result.phases) {
+			auto phase = before->phases.find(entry.first);
+			if (phase == before->phases.end()) {
+				continue;
+			}
+
+			for (int i = 0; i < 4; ++i) {
+				const double old_value = stat(phase->second, i);
+				const double new_value = stat(entry.second, i);
+				if (new_value - old_value > BENCHMARK_MIN_DELTA && new_value > old_value * (1 + threshold / 100)) {
+					std::cerr << "REGRESSION " << result.name << " " << entry.first << " " << STAT_NAMES[i] << ": "
+						<< old_value << " ms -> " << new_value << " ms" << std::endl;
+					passed = false;
+				}
+			}
+		}
+	}
+	return passed;
+}
@@ -0,0 +1,83 @@
+#ifndef I3D_BENCHMARK_H
+#define I3D_BENCHMARK_H
+
+#include "Scenario.h"
+#include "State/WorldState.h"
+
+class GameManager;
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct PhaseStats {
+	double mean;
+	double p50;
+	double p95;
+	double p99;
+	double allocations; // mean per tick, only filled in when tracking allocations
+	double bytes;
+};
+
+struct ScenarioResult {
+	std::string name;
+	int ticks;
+	std::map<std::string, PhaseStats> phases; // ms, keyed by Profiler phase name
+	std::uint64_t steady_state_violations;
+};
+
+// Runs scenarios through the normal tick (and optionally display) path at a
+// fixed dt and seed, and turns the per-phase timings into JSON that can be
+// diffed against an earlier run. Needs a current GL context for the assets,
+// even when not rendering.
+class Benchmark {
+public:
+	Benchmark(bool render, int width, int height);
+
+	// Times allocations as well, and with strict, aborts on the first
+	// allocation in a steady state section after warming up
+	void trackAllocations(bool strict);
+
+	// Only matters with render
+	void setOcclusionCulling(bool setting);
+
+	// Applied to every scenario's game before its setup, e.g. a moment read
+	// from a state stream
+	void setStartingState(const WorldState& state);
+
+	ScenarioResult run(const Scenario& scenario) const;
+
+	// Grows a single field towards population, at most spawn_rate asteroids a
+	// tick, and times STRESS_SAMPLE_TICKS at each checkpoint on the way. One
+	// result per checkpoint, named "stress-<N>". Stops early once ticks blow
+	// through STRESS_TICK_BUDGET, as the next checkpoint would only be slower
+	std::vector<ScenarioResult> stress(int population, int spawn_rate) const;
+
+	static PhaseStats summarise(std::vector<double> samples);
+
+	static void writeJson(std::ostream& out, const std::vector<ScenarioResult>& results);
+	static bool readJson(const std::string& filename, std::vector<ScenarioResult>& results);
+
+	// Prints every stat more than threshold % slower than the baseline and
+	// returns false if there were any. Scenarios or phases missing from the
+	// baseline are skipped
+	static bool compare(const std::vector<ScenarioResult>& baseline, const std::vector<ScenarioResult>& results,
+		float threshold);
+
+private:
+	void prepare(GameManager& game) const;
+	void step(GameManager& game) const;
+	static ScenarioResult collect(const std::string& name, int ticks);
+
+	bool render;
+	bool strict;
+	bool occlusion_culling;
+	int width;
+	int height;
+	std::unique_ptr<WorldState> starting_state;
+};
+
+#endif // I3D_BENCHMARK_H
@@ -0,0 +1,106 @@
+#include "Scenario.h"
+#include "GameManager.h"
+
+#include "Asteroids/Asteroid.h"
+#include "Explosion/Explosion.h"
+#include "Constants/ArenaConstants.h"
+#include "State/Snapshot.h"
+
+#include <memory>
+
+const std::vector<Scenario>& scenario::all() {
+	static const std::shared_ptr<Snapshot> rewind_point = std::make_shared<Snapshot>();
+
+	static const std::vector<Scenario> scenarios = {
+		// Nothing pressed; just the first wave drifting in and the satellite going round
+		{ "idle-arena", 1800, nullptr, nullptr },
+
+		// 200 asteroids converging on one point above the ship, so they pile into
+		// each other there and then bounce around the arena. Topped back up
+		// whenever some are destroyed or one hits the ship and resets the game
+		{ "asteroids-200", 1800,
+			nullptr,
+			[](GameManager& game, int) {
+				ecs::World& world = game.getWorld();
+				const int missing = 200 - static_cast<int>(world.count<Asteroid>());
+				if (missing > 0) {
+					game.getAsteroidField().launchAsteroidsAt(world, Vector3D(0, ARENA_DIM / 2, 0), missing);
+				}
+			} },
+
+		// 150 asteroids converging as in asteroids-200, with a few taken out of
+		// the middle of the field every half second and the field topped back
+		// up every five, so the contact cache sees it shrink as well as grow
+		{ "shrinking-field", 1800,
+			[](GameManager& game) {
+				game.getAsteroidField().launchAsteroidsAt(game.getWorld(), Vector3D(0, ARENA_DIM / 2, 0), 150);
+			},
+			[](GameManager& game, int tick) {
+				ecs::World& world = game.getWorld();
+				const size_t count = world.count<Asteroid>();
+				if (tick % 300 == 0) {
+					const int missing = 150 - static_cast<int>(count);
+					if (missing > 0) {
+						game.getAsteroidField().launchAsteroidsAt(world, Vector3D(0, ARENA_DIM / 2, 0), missing);
+					}
+				}
+				else if (tick % 30 == 0) {
+					// Up to ten from halfway along, always leaving one. Flushed
+					// here, between ticks, so they're gone before it runs
+					size_t row = 0;
+					world.each<Asteroid>([&world, &row, count](ecs::EntityId id, Asteroid&) {
+						if (row >= count / 2 && row < count / 2 + 10 && row + 1 < count) {
+							world.destroy(id);
+						}
+						++row;
+					});
+					world.flush();
+				}
+			} },
+
+		// Fire held down for a minute of game time
+		{ "sustained-fire", 3600,
+			[](GameManager& game) {
+				game.onKeyDown(' ', 0, 0);
+			},
+			nullptr },
+
+		// A burst of 25 asteroid-sized explosions every two seconds
+		{ "mass-explosion", 600,
+			nullptr,
+			[](GameManager& game, int tick) {
+				if (tick % 120 != 0) {
+					return;
+				}
+				for (int i = 0; i < 25; ++i) {
+					explosion::populate(game.getWorld(), Vector3D::randomUnit() * (ARENA_DIM / 2));
+				}
+			} },
+
+		// Firing into 100 asteroids, saving a snapshot every second and going back
+		// to it half a second later, timed in the "snapshot" and "restore" phases
+		{ "rewind", 1800,
+			[](GameManager& game) {
+				game.onKeyDown(' ', 0, 0);
+				game.getAsteroidField().launchAsteroidsAt(game.getWorld(), Vector3D(0, ARENA_DIM / 2, 0), 100);
+			},
+			[](GameManager& game, int tick) {
+				if (tick % 60 == 0) {
+					game.saveSnapshot(*rewind_point);
+				}
+				else if (tick % 60 == 30) {
+					game.restoreSnapshot(*rewind_point);
+				}
+			} },
+	};
+	return scenarios;
+}
+
+const Scenario* scenario::find(const std::string& name) {
+	for (const Scenario& scenario : all()) {
+		if (scenario.name == name) {
+			return &scenario;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,24 @@
+#ifndef I3D_SCENARIO_H
+#define I3D_SCENARIO_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class GameManager;
+
+// A named, repeatable situation to time the game in. setup runs once on a
+// fresh game, step before every tick (with the tick number), either may be empty
+struct Scenario {
+	std::string name;
+	int ticks;
+	std::function<void(GameManager&)> setup;
+	std::function<void(GameManager&, int)> step;
+};
+
+namespace scenario {
+	const std::vector<Scenario>& all();
+	const Scenario* find(const std::string& name); // nullptr if there's no such scenario
+}
+
+#endif // I3D_SCENARIO_H
@@ -1,46 +1,19 @@
 #include "Bullet.h"
-#include "GlutHeaders.h"
 #include "Assets/Asset.h"
+#include "ECS/Components.h"
+#include "Animation/AnimationDrawer.h"
 
-#include "World/Camera.h"
-#include "Math/Quaternion.h"
-
-Bullet::Bullet(Vector3D position, Vector3D velocity)
-	: animation(AnimationDrawer(BULLET_GRID_SIZE, BULLET_TEX_ROWS, BULLET_TEX_COLS, BULLET_FRAMERATE, true))
-	, position(position)
-	, velocity(velocity)
-	, to_delete(false) { }
-
-void Bullet::update(float dt) {
-	position += velocity * dt;
-	animation.update(dt);
-}
-
-void Bullet::draw() const {
-	glDisable(GL_LIGHTING);
-	glEnable(GL_TEXTURE_2D);
-
-	glColor3f(1.0, 1.0, 1.0);
-	glPushMatrix();
-		glTranslatef(position.X, position.Y, position.Z);
-		glMultMatrixf(Quaternion::toMatrix(Camera::getRotation()).data());
-		glScalef(BULLET_SIZE, BULLET_SIZE, BULLET_SIZE);
-
-		glBindTexture(GL_TEXTURE_2D, Asset::getTextureId(Entity::bullets));
-		animation.draw();
-	glPopMatrix();
-
-	glDisable(GL_TEXTURE_2D);
-	glEnable(GL_LIGHTING);
-}
-
-const Vector3D& Bullet::getPosition() const {
-	return position;
+// Just ahead of the ship so it doesn't start out inside it
+ecs::EntityId bullet::spawn(ecs::World& world, const Vector3D& position, const Vector3D& forward) {
+	return create(world, position + 10 * forward, BULLET_SPEED * forward);
 }
 
-void Bullet::markForDeletion() {
-	to_delete = true;
+ecs::EntityId bullet::create(ecs::World& world, const Vector3D& position, const Vector3D& velocity) {
+	return world.create(
+		Bullet{},
+		Position{ position },
+		PreviousPosition{ position },
+		Velocity{ velocity },
+		Billboard{ Mesh::bullet, Asset::getTextureId(Entity::bullets), BULLET_SIZE },
+		AnimationDrawer(BULLET_GRID_SIZE, BULLET_TEX_ROWS, BULLET_TEX_COLS, BULLET_FRAMERATE, true));
 }
-bool Bullet::markedForDeletion() {
-	return to_delete;
-}
\ No newline at end of file
@@ -2,31 +2,19 @@
 #define I3D_BULLET_H
 
 #include "Constants/BulletConstants.h"
-#include "Transparent/Transparent.h"
-#include "Animation/AnimationDrawer.h"
+#include "ECS/World.h"
 #include "Math/Vector3D.h"
 
-#include <array>
-#include <utility>
+// Marks the entities that are bullets. Besides this they have a Position,
+// PreviousPosition (their path is swept for hits), Velocity, Billboard and
+// looping AnimationDrawer
+struct Bullet {};
 
-class Bullet : public Transparent {
-public:
-	Bullet(Vector3D position, Vector3D velocity);
+namespace bullet {
+	ecs::EntityId spawn(ecs::World& world, const Vector3D& position, const Vector3D& forward);
 
-	void update(float dt);
-	void draw() const override;
+	// Exactly where and how it's given, e.g. back from a state stream
+	ecs::EntityId create(ecs::World& world, const Vector3D& position, const Vector3D& velocity);
+}
 
-	const Vector3D& getPosition() const override;
-
-	void markForDeletion();
-	bool markedForDeletion();
-
-private:
-	AnimationDrawer animation;
-
-	Vector3D position;
-	Vector3D velocity;
-	bool to_delete;
-};
-
-#endif // I3D_BULLET_H
\ No newline at end of file
+#endif // I3D_BULLET_H
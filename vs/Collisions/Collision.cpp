@@ -1,42 +1,97 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <cstring>
 
 #include "Collision.h"
 #include "Enums/Enum.h"
 #include "Constants/ArenaConstants.h"
 
-bool collision::withWall(const Wall& wall, const Vector3D& position, float radius) {
-	bool collision = false;
-	if (wall.getSide() == Side::TOP) {
-		collision = position.Y + radius > ARENA_DIM;
-	}
-	else if (wall.getSide() == Side::BOTTOM) {
-		collision = position.Y - radius < -ARENA_DIM;
-	}
-	else if (wall.getSide() == Side::LEFT) {
-		collision = position.X - radius < -ARENA_DIM;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define I3D_SSE2
+#	include <emmintrin.h>
+#endif
+
+namespace {
+	unsigned char sideBit(Side side) {
+		return static_cast<unsigned char>(1 << static_cast<int>(side));
 	}
-	else if (wall.getSide() == Side::RIGHT) {
-		collision = position.X + radius > ARENA_DIM;
+
+	unsigned char wallMask(float x, float y, float z, float radius) {
+		unsigned char mask = 0;
+		if (y + radius > ARENA_DIM) mask |= sideBit(Side::TOP);
+		if (y - radius < -ARENA_DIM) mask |= sideBit(Side::BOTTOM);
+		if (x - radius < -ARENA_DIM) mask |= sideBit(Side::LEFT);
+		if (x + radius > ARENA_DIM) mask |= sideBit(Side::RIGHT);
+		if (z + radius > ARENA_DIM) mask |= sideBit(Side::FRONT);
+		if (z - radius < -ARENA_DIM) mask |= sideBit(Side::BACK);
+		return mask;
 	}
-	else if (wall.getSide() == Side::FRONT) {
-		collision = position.Z + radius > ARENA_DIM;
+}
+
+bool collision::withWall(const Wall& wall, const Vector3D& position, float radius) {
+	return (withWalls(position, radius) & wallBit(wall)) != 0;
+}
+
+unsigned char collision::wallBit(const Wall& wall) {
+	return sideBit(wall.getSide());
+}
+
+unsigned char collision::withWalls(const Vector3D& position, float radius) {
+	return wallMask(position.X, position.Y, position.Z, radius);
+}
+
+void collision::withWalls(const float* x, const float* y, const float* z, const float* radius, size_t count, unsigned char* masks) {
+	size_t i = 0;
+
+#ifdef I3D_SSE2
+	const __m128 max = _mm_set1_ps(ARENA_DIM);
+	const __m128 min = _mm_set1_ps(-ARENA_DIM);
+	for (; i + 4 <= count; i += 4) {
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128 pz = _mm_loadu_ps(z + i);
+		const __m128 r = _mm_loadu_ps(radius + i);
+
+		// Each comparison sets a lane to all ones where it hits; keep that
+		// wall's bit from it
+		__m128i bits = _mm_setzero_si128();
+		auto face = [&bits](__m128 hit, Side side) {
+			bits = _mm_or_si128(bits, _mm_and_si128(_mm_castps_si128(hit), _mm_set1_epi32(sideBit(side))));
+		};
+		face(_mm_cmpgt_ps(_mm_add_ps(py, r), max), Side::TOP);
+		face(_mm_cmplt_ps(_mm_sub_ps(py, r), min), Side::BOTTOM);
+		face(_mm_cmplt_ps(_mm_sub_ps(px, r), min), Side::LEFT);
+		face(_mm_cmpgt_ps(_mm_add_ps(px, r), max), Side::RIGHT);
+		face(_mm_cmpgt_ps(_mm_add_ps(pz, r), max), Side::FRONT);
+		face(_mm_cmplt_ps(_mm_sub_ps(pz, r), min), Side::BACK);
+
+		// narrow the four 32 bit lanes down to their low bytes
+		const __m128i words = _mm_packs_epi32(bits, bits);
+		const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+		std::memcpy(masks + i, &packed, 4);
 	}
-	else if (wall.getSide() == Side::BACK) {
-		collision = position.Z - radius < -ARENA_DIM;
+#endif
+
+	for (; i < count; ++i) {
+		masks[i] = wallMask(x[i], y[i], z[i], radius[i]);
 	}
-	return collision;
 }
 
-void collision::resolve(const Wall& wall, Asteroid& asteroid) {
+// slightly nudge when reversing so they don't get stuck or jitter
+void collision::resolve(const Wall& wall, Position& position, Velocity& velocity) {
+	Vector3D& p = position.value;
+	Vector3D& v = velocity.value;
 	if (wall.getSide() == Side::TOP || wall.getSide() == Side::BOTTOM) {
-		asteroid.reverseY();
+		p.Y = p.Y < 0 ? p.Y + 1 : p.Y - 1;
+		v.Y = -v.Y;
 	}
 	else if (wall.getSide() == Side::LEFT || wall.getSide() == Side::RIGHT) {
-		asteroid.reverseX();
+		p.X = p.X < 0 ? p.X + 1 : p.X - 1;
+		v.X = -v.X;
 	}
 	else if (wall.getSide() == Side::FRONT || wall.getSide() == Side::BACK) {
-		asteroid.reverseZ();
+		p.Z = p.Z < 0 ? p.Z + 1 : p.Z - 1;
+		v.Z = -v.Z;
 	}
 }
 
@@ -44,19 +99,66 @@ bool collision::withAsteroid(const Vector3D& asteroid_pos, float asteroid_radius
 	return Vector3D::distance(asteroid_pos, other_position) < asteroid_radius + other_radius;
 }
 
-void collision::resolve(Asteroid& a1, Asteroid& a2) {
-	Vector3D x1 = a1.getPosition();
-	Vector3D x2 = a2.getPosition();
-	Vector3D v1 = a1.getVelocity();
-	Vector3D v2 = a2.getVelocity();
-	float m1 = a1.getMass();
-	float m2 = a2.getMass();
-	float distance = Vector3D::distance(a1.getPosition(), a2.getPosition());
-	float squared_distance = distance * distance;
+bool collision::sweepWall(const Wall& wall, const Vector3D& start, const Vector3D& end, float& time) {
+	// how far past the wall each end of the path is, positive once through
+	float from = 0;
+	float to = 0;
+	if (wall.getSide() == Side::TOP) {
+		from = start.Y - ARENA_DIM;
+		to = end.Y - ARENA_DIM;
+	}
+	else if (wall.getSide() == Side::BOTTOM) {
+		from = -ARENA_DIM - start.Y;
+		to = -ARENA_DIM - end.Y;
+	}
+	else if (wall.getSide() == Side::LEFT) {
+		from = -ARENA_DIM - start.X;
+		to = -ARENA_DIM - end.X;
+	}
+	else if (wall.getSide() == Side::RIGHT) {
+		from = start.X - ARENA_DIM;
+		to = end.X - ARENA_DIM;
+	}
+	else if (wall.getSide() == Side::FRONT) {
+		from = start.Z - ARENA_DIM;
+		to = end.Z - ARENA_DIM;
+	}
+	else if (wall.getSide() == Side::BACK) {
+		from = -ARENA_DIM - start.Z;
+		to = -ARENA_DIM - end.Z;
+	}
+
+	if (to <= 0) {
+		return false;
+	}
+	time = from >= 0 ? 0 : from / (from - to);
+	return true;
+}
+
+// Solves |start + t * (end - start) - asteroid_pos| = asteroid_radius for the
+// smaller t. Asteroids move slowly enough next to bullets to treat as still
+bool collision::sweepAsteroid(const Vector3D& asteroid_pos, float asteroid_radius, const Vector3D& start, const Vector3D& end, float& time) {
+	const Vector3D path = end - start;
+	const Vector3D offset = start - asteroid_pos;
 
-	Vector3D new_v1 = v1 - ((2 * m2 / (m1 + m2)) * (Vector3D::dot(v1 - v2, x1 - x2) / squared_distance) * (x1 - x2));
-	Vector3D new_v2 = v2 - ((2 * m1 / (m1 + m2)) * (Vector3D::dot(v2 - v1, x2 - x1) / squared_distance) * (x2 - x1));
+	const float c = Vector3D::dot(offset, offset) - asteroid_radius * asteroid_radius;
+	if (c < 0) {
+		// started inside
+		time = 0;
+		return true;
+	}
 
-	a1.setVelocity(new_v1);
-	a2.setVelocity(new_v2);
+	const float a = Vector3D::dot(path, path);
+	const float b = 2 * Vector3D::dot(offset, path);
+	const float discriminant = b * b - 4 * a * c;
+	if (a == 0 || discriminant < 0) {
+		return false;
+	}
+
+	const float t = (-b - std::sqrt(discriminant)) / (2 * a);
+	if (t < 0 || t > 1) {
+		return false;
+	}
+	time = t;
+	return true;
 }
@@ -1,18 +1,31 @@
 #ifndef I3D_COLLISION_H
 #define I3D_COLLISION_H
 
-#include "Ship/Ship.h"
-#include "Asteroids/Asteroid.h"
+#include "ECS/Components.h"
 #include "Arena/Wall.h"
 
+#include <cstddef>
 #include <memory>
 
 namespace collision {
 	bool withWall(const Wall& wall, const Vector3D& position, float radius = 0);
-	void resolve(const Wall& wall, Asteroid& asteroid);
+	void resolve(const Wall& wall, Position& position, Velocity& velocity);
 
+	// Which walls a sphere reaches past, one wallBit per wall. The batched
+	// version does count spheres at once from separate coordinate arrays,
+	// four at a time where SSE2 is available
+	unsigned char wallBit(const Wall& wall);
+	unsigned char withWalls(const Vector3D& position, float radius = 0);
+	void withWalls(const float* x, const float* y, const float* z, const float* radius, size_t count, unsigned char* masks);
+
+	// Pairs of asteroids that this finds touching are solved by a ContactSolver
 	bool withAsteroid(const Vector3D& asteroid_pos, float asteroid_radius, const Vector3D& other_position, float other_radius = 0);
-	void resolve(Asteroid& a1, Asteroid& a2);
+
+	// Swept versions for things that move too far in a tick to test only
+	// where they end up. On a hit, time is how far along start -> end the
+	// first contact is, from 0 to 1
+	bool sweepWall(const Wall& wall, const Vector3D& start, const Vector3D& end, float& time);
+	bool sweepAsteroid(const Vector3D& asteroid_pos, float asteroid_radius, const Vector3D& start, const Vector3D& end, float& time);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "ContactCache.h"
+#include "Constants/AsteroidConstants.h"
+
+#include <limits>
+
+ContactCache::ContactCache()
+	: enabled(true)
+	, clock(0) {}
+
+void ContactCache::begin(const ContactBodies& bodies, float dt) {
+	enabled = bodies.size() <= CONTACT_CACHE_MAX_ASTEROIDS;
+	if (!enabled || bodies.empty()) {
+		// Starting over keeps the clock small enough for floats to stay precise
+		clear();
+		return;
+	}
+	clock += dt;
+
+	// Laid out by j then i, so new slots on the end leave existing pairs put
+	// and one asteroid's pairs with those before it are contiguous
+	const size_t count = bodies.size();
+	wake_times.resize(count * (count - 1) / 2, 0);
+
+	// Dropping the slots past the end first keeps invalidate() to pairs that
+	// still have a wake time
+	if (ids.size() > count) {
+		ids.resize(count);
+	}
+	const size_t known = ids.size();
+	for (size_t i = 0; i < known; ++i) {
+		if (ids[i] != bodies[i].id) {
+			invalidate(i);
+			ids[i] = bodies[i].id;
+		}
+	}
+	for (size_t i = known; i < count; ++i) {
+		ids.push_back(bodies[i].id);
+	}
+}
+
+bool ContactCache::withAsteroid(size_t i, size_t j, const ContactBody& a1, const ContactBody& a2) {
+	if (enabled && clock < wake_times[index(i, j)]) {
+		return false;
+	}
+
+	const float gap = Vector3D::distance(a1.position->value, a2.position->value) - a1.asteroid->radius - a2.asteroid->radius;
+	if (gap < 0) {
+		return true;
+	}
+
+	if (enabled) {
+		const float closing_speed = Vector3D::magnitude(a1.velocity->value - a2.velocity->value);
+		wake_times[index(i, j)] = closing_speed > 0
+			? clock + gap / closing_speed
+			: std::numeric_limits<float>::infinity();
+	}
+	return false;
+}
+
+void ContactCache::invalidate(size_t i) {
+	if (!enabled) {
+		return;
+	}
+
+	for (size_t j = 0; j < ids.size(); ++j) {
+		if (j < i) {
+			wake_times[index(j, i)] = 0;
+		}
+		else if (j > i) {
+			wake_times[index(i, j)] = 0;
+		}
+	}
+}
+
+void ContactCache::clear() {
+	clock = 0;
+	ids.clear();
+	wake_times.clear();
+}
+
+size_t ContactCache::index(size_t i, size_t j) const {
+	return j * (j - 1) / 2 + i;
+}
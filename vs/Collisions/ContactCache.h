@@ -0,0 +1,62 @@
+#ifndef I3D_CONTACTCACHE_H
+#define I3D_CONTACTCACHE_H
+
+#include "Asteroids/Asteroid.h"
+#include "ECS/Components.h"
+#include "ECS/World.h"
+#include "Memory/FrameAllocator.h"
+
+#include <cstddef>
+#include <vector>
+
+// An asteroid's entity and components, gathered once a tick so pairs can be
+// looked up by their place in the list. Only good for the tick, and not past
+// anything that flushes or clears the world
+struct ContactBody {
+	ecs::EntityId id;
+	Asteroid* asteroid;
+	Position* position;
+	Velocity* velocity;
+};
+
+using ContactBodies = FrameVector<ContactBody>;
+
+// Remembers, for each pair of asteroids, the earliest time they could touch.
+// Between collisions asteroids fly in straight lines, so a pair that's d
+// apart closing at no more than |v1 - v2| can't meet for d / |v1 - v2|
+// seconds, and needn't be tested until then. Anything that changes an
+// asteroid's velocity has to invalidate() it, since the bounds assumed the
+// old one.
+//
+// Pairs are stored by their slots in the tick's bodies, which follow the
+// asteroids' rows in the world, and each slot remembers the entity it held;
+// when begin() finds a different entity in a slot (one was destroyed and the
+// last row moved into its place, or a wave arrived) that slot's pairs start
+// over.
+class ContactCache {
+public:
+	ContactCache();
+
+	// Once a tick before testing pairs, dt being the time since the last call
+	void begin(const ContactBodies& bodies, float dt);
+
+	// For the asteroids in slots i < j. Stands in for collision::withAsteroid,
+	// but only actually tests the pair once its bound is up, and works out a
+	// new bound whenever the test misses
+	bool withAsteroid(size_t i, size_t j, const ContactBody& a1, const ContactBody& a2);
+
+	// The asteroid in slot i changed velocity, so test all its pairs again
+	void invalidate(size_t i);
+
+	void clear();
+
+private:
+	size_t index(size_t i, size_t j) const;
+
+	bool enabled; // too many asteroids to keep a bound per pair
+	float clock;
+	std::vector<ecs::EntityId> ids;
+	std::vector<float> wake_times; // by index(i, j)
+};
+
+#endif // I3D_CONTACTCACHE_H
@@ -0,0 +1,218 @@
+#include "ContactSolver.h"
+#include "Constants/AsteroidConstants.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+	size_t constexpr NO_ISLAND = std::numeric_limits<size_t>::max();
+}
+
+ContactSolver::ContactSolver(int workers)
+	: asteroids(nullptr)
+	, next_island(0)
+	, generation(0)
+	, remaining(0)
+	, stopping(false) {
+	for (int worker = 0; worker < workers; ++worker) {
+		this->workers.emplace_back(&ContactSolver::work, this);
+	}
+}
+
+ContactSolver::~ContactSolver() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+void ContactSolver::clear() {
+	contacts.clear();
+}
+
+void ContactSolver::add(size_t i, size_t j) {
+	contacts.push_back({ i, j, Vector3D(), 0, 0, 0, 0 });
+}
+
+void ContactSolver::solve(ContactBodies& asteroids, ContactCache& cache) {
+	if (contacts.empty()) {
+		return;
+	}
+
+	this->asteroids = &asteroids;
+	buildIslands(asteroids.size());
+
+	next_island = 0;
+	if (workers.empty() || islands.size() < 2 || contacts.size() < static_cast<size_t>(CONTACT_SOLVER_PARALLEL_MIN)) {
+		run();
+	}
+	else {
+		dispatch();
+	}
+	this->asteroids = nullptr;
+
+	for (size_t body : bodies) {
+		cache.invalidate(body);
+	}
+}
+
+size_t ContactSolver::root(size_t slot) {
+	while (parents[slot] != slot) {
+		parents[slot] = parents[parents[slot]];
+		slot = parents[slot];
+	}
+	return slot;
+}
+
+// Unites the slots of every contact, then sorts the contacts by island,
+// keeping the order they were found in within each
+void ContactSolver::buildIslands(size_t asteroid_count) {
+	bodies.clear();
+	for (const Contact& contact : contacts) {
+		bodies.push_back(contact.a);
+		bodies.push_back(contact.b);
+	}
+	std::sort(bodies.begin(), bodies.end());
+	bodies.erase(std::unique(bodies.begin(), bodies.end()), bodies.end());
+
+	parents.resize(asteroid_count);
+	island_of.resize(asteroid_count);
+	for (size_t body : bodies) {
+		parents[body] = body;
+		island_of[body] = NO_ISLAND;
+	}
+	// the lower slot becomes the root, so islands come out the same every time
+	for (const Contact& contact : contacts) {
+		const size_t a = root(contact.a);
+		const size_t b = root(contact.b);
+		parents[std::max(a, b)] = std::min(a, b);
+	}
+
+	islands.clear();
+	for (const Contact& contact : contacts) {
+		size_t& island = island_of[root(contact.a)];
+		if (island == NO_ISLAND) {
+			island = islands.size();
+			islands.push_back({ 0, 0 });
+		}
+		++islands[island].count;
+	}
+
+	size_t first = 0;
+	for (Island& island : islands) {
+		island.first = first;
+		first += island.count;
+		island.count = 0;
+	}
+	sorted.resize(contacts.size());
+	for (const Contact& contact : contacts) {
+		Island& island = islands[island_of[root(contact.a)]];
+		sorted[island.first + island.count++] = contact;
+	}
+
+	// Big clusters first, so no thread is left with one at the end
+	std::sort(islands.begin(), islands.end(), [](const Island& a, const Island& b) { return a.count > b.count; });
+}
+
+// The calling thread takes islands too, so with no workers it's all done inline
+void ContactSolver::dispatch() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		++generation;
+		remaining = static_cast<int>(workers.size());
+	}
+	started.notify_all();
+
+	run();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] { return remaining == 0; });
+}
+
+void ContactSolver::work() {
+	unsigned int seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			started.wait(lock, [this, seen] { return generation != seen || stopping; });
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+		}
+
+		run();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--remaining == 0) {
+			finished.notify_one();
+		}
+	}
+}
+
+void ContactSolver::run() {
+	for (size_t i = next_island++; i < islands.size(); i = next_island++) {
+		solveIsland(islands[i]);
+	}
+}
+
+void ContactSolver::solveIsland(const Island& island) {
+	ContactBodies& field = *asteroids;
+	Contact* const begin = sorted.data() + island.first;
+	Contact* const end = begin + island.count;
+
+	// The normals and targets are fixed from where things were when found
+	for (Contact* contact = begin; contact != end; ++contact) {
+		const ContactBody& a = field[contact->a];
+		const ContactBody& b = field[contact->b];
+		const Vector3D offset = a.position->value - b.position->value;
+		const float distance = Vector3D::magnitude(offset);
+		contact->normal = distance > 0 ? offset / distance : Vector3D::up();
+		contact->inverse_mass_a = 1 / a.asteroid->mass;
+		contact->inverse_mass_b = 1 / b.asteroid->mass;
+
+		// Already parting pairs are only kept from closing again
+		const float closing = Vector3D::dot(a.velocity->value - b.velocity->value, contact->normal);
+		contact->target = closing < 0 ? -CONTACT_RESTITUTION * closing : 0;
+		contact->impulse = 0;
+	}
+
+	for (int pass = 0; pass < CONTACT_VELOCITY_ITERATIONS; ++pass) {
+		for (Contact* contact = begin; contact != end; ++contact) {
+			Vector3D& a = field[contact->a].velocity->value;
+			Vector3D& b = field[contact->b].velocity->value;
+			const float speed = Vector3D::dot(a - b, contact->normal);
+			const float needed = (contact->target - speed) / (contact->inverse_mass_a + contact->inverse_mass_b);
+			const float total = std::max(contact->impulse + needed, 0.0f);
+			const float change = total - contact->impulse;
+			if (change == 0) {
+				continue;
+			}
+			contact->impulse = total;
+			a += contact->normal * (change * contact->inverse_mass_a);
+			b -= contact->normal * (change * contact->inverse_mass_b);
+		}
+	}
+
+	// The lighter of a pair moves further
+	for (int pass = 0; pass < CONTACT_POSITION_ITERATIONS; ++pass) {
+		for (Contact* contact = begin; contact != end; ++contact) {
+			const ContactBody& a = field[contact->a];
+			const ContactBody& b = field[contact->b];
+			const Vector3D offset = a.position->value - b.position->value;
+			const float distance = Vector3D::magnitude(offset);
+			const float overlap = a.asteroid->radius + b.asteroid->radius - distance - CONTACT_SLOP;
+			if (overlap <= 0) {
+				continue;
+			}
+			const Vector3D normal = distance > 0 ? offset / distance : contact->normal;
+			const Vector3D push = normal * (overlap * CONTACT_CORRECTION / (contact->inverse_mass_a + contact->inverse_mass_b));
+			a.position->value += push * contact->inverse_mass_a;
+			b.position->value -= push * contact->inverse_mass_b;
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#ifndef I3D_CONTACTSOLVER_H
+#define I3D_CONTACTSOLVER_H
+
+#include "ContactCache.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Sequential impulse solver for the asteroid contacts found in a tick.
+// Contacts are first gathered into islands, the groups of asteroids that
+// touch each other directly or through others, so a cluster is solved as
+// a whole rather than one pair at a time. No island shares an asteroid
+// with another, so they're shared out between the workers and the calling
+// thread and solved side by side; each one alone is solved in the order
+// its contacts were found, so the result doesn't depend on the threads.
+//
+// An island gets CONTACT_VELOCITY_ITERATIONS passes over its contacts,
+// each pass applying whatever impulse brings a pair to the speed it would
+// part at after an elastic bounce. Every contact's impulse is summed over
+// the passes and never allowed below zero, so a contact can only push.
+// Then any overlap left is pushed out of the positions themselves, which
+// leaves the velocities alone and doesn't step anything on by dt again.
+class ContactSolver {
+public:
+	explicit ContactSolver(int workers);
+	~ContactSolver();
+
+	ContactSolver(const ContactSolver&) = delete;
+	ContactSolver& operator=(const ContactSolver&) = delete;
+
+	// Starts a tick's contacts
+	void clear();
+
+	// The asteroids in slots i and j are touching
+	void add(size_t i, size_t j);
+
+	// Solves everything added since clear(), and invalidates every asteroid
+	// it moved in the cache
+	void solve(ContactBodies& asteroids, ContactCache& cache);
+
+private:
+	struct Contact {
+		size_t a;
+		size_t b;
+		Vector3D normal; // from b to a
+		float inverse_mass_a;
+		float inverse_mass_b;
+		float target; // the speed they part at
+		float impulse; // summed over the passes
+	};
+
+	// A run of sorted contacts
+	struct Island {
+		size_t first;
+		size_t count;
+	};
+
+	size_t root(size_t slot);
+	void buildIslands(size_t asteroid_count);
+
+	void dispatch();
+	void work();
+	void run();
+	void solveIsland(const Island& island);
+
+	ContactBodies* asteroids; // while solving
+	std::vector<Contact> contacts; // as found
+	std::vector<Contact> sorted; // by island
+	std::vector<Island> islands; // biggest first
+	std::vector<size_t> parents; // union-find over asteroid slots
+	std::vector<size_t> island_of; // by root slot
+	std::vector<size_t> bodies; // every slot in a contact, once
+	std::atomic<size_t> next_island;
+
+	// The workers wait for the generation to change, take islands until
+	// there are none left and count themselves off
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable started;
+	std::condition_variable finished;
+	unsigned int generation;
+	int remaining;
+	bool stopping;
+};
+
+#endif // I3D_CONTACTSOLVER_H
@@ -0,0 +1,31 @@
+#include "WallBatch.h"
+#include "Collision.h"
+
+void WallBatch::reserve(size_t count) {
+	x.reserve(count);
+	y.reserve(count);
+	z.reserve(count);
+	radius.reserve(count);
+	masks.reserve(count);
+}
+
+size_t WallBatch::add(const Vector3D& position, float radius) {
+	x.push_back(position.X);
+	y.push_back(position.Y);
+	z.push_back(position.Z);
+	this->radius.push_back(radius);
+	return x.size() - 1;
+}
+
+size_t WallBatch::size() const {
+	return x.size();
+}
+
+void WallBatch::run() {
+	masks.resize(x.size());
+	collision::withWalls(x.data(), y.data(), z.data(), radius.data(), x.size(), masks.data());
+}
+
+unsigned char WallBatch::getMask(size_t index) const {
+	return masks[index];
+}
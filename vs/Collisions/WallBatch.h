@@ -0,0 +1,31 @@
+#ifndef I3D_WALLBATCH_H
+#define I3D_WALLBATCH_H
+
+#include "Math/Vector3D.h"
+#include "Memory/FrameAllocator.h"
+
+#include <cstddef>
+
+// Gathers spheres to test against the arena walls in one collision::withWalls
+// call. Lives in the frame arena, so only for the tick it was made in
+class WallBatch {
+public:
+	void reserve(size_t count);
+
+	// Returns the index to look the result up by
+	size_t add(const Vector3D& position, float radius);
+	size_t size() const;
+	void run();
+
+	// collision::wallBit of each wall the sphere reaches past
+	unsigned char getMask(size_t index) const;
+
+private:
+	FrameVector<float> x;
+	FrameVector<float> y;
+	FrameVector<float> z;
+	FrameVector<float> radius;
+	FrameVector<unsigned char> masks;
+};
+
+#endif // I3D_WALLBATCH_H
@@ -17,5 +17,28 @@ float constexpr ASTEROID_STACK_COUNT = 10;
 float constexpr ASTEROID_SECTOR_COUNT = 10;
 
 float constexpr ASTEROID_FUDGE = 0.3; // +- % to the XZ plane of each asteroid vertex (keep between 0 and 1!)
+int constexpr ASTEROID_SHAPE_COUNT = 16; // pre-built lumpy spheres shared between asteroids when not instancing
+
+// One layer each of the asteroid array texture, or separate textures when not instancing
+constexpr const char* ASTEROID_TEXTURES[] = {
+	"./Assets/Asteroids/asteroid1.jpg",
+	"./Assets/Asteroids/asteroid2.jpg",
+	"./Assets/Asteroids/asteroid3.jpg",
+	"./Assets/Asteroids/asteroid4.jpg"
+};
+int constexpr ASTEROID_TEXTURE_COUNT = sizeof(ASTEROID_TEXTURES) / sizeof(ASTEROID_TEXTURES[0]);
+
+// The contact cache keeps a bound per pair, so n^2 / 2 floats; past this many
+// asteroids every pair is just tested every tick instead
+int constexpr CONTACT_CACHE_MAX_ASTEROIDS = 2048;
+
+// Contact solver
+int constexpr CONTACT_VELOCITY_ITERATIONS = 8; // impulse passes over each island
+int constexpr CONTACT_POSITION_ITERATIONS = 3; // overlap passes after them
+float constexpr CONTACT_RESTITUTION = 1; // asteroids bounce off each other elastically
+float constexpr CONTACT_SLOP = 1; // units of overlap left alone, so touching pairs don't jitter
+float constexpr CONTACT_CORRECTION = 0.8f; // share of the rest pushed out per position pass
+int constexpr CONTACT_SOLVER_MAX_WORKERS = 3; // besides the simulation thread, also capped at the spare cores
+int constexpr CONTACT_SOLVER_PARALLEL_MIN = 64; // contacts in a tick before the workers are woken for them
 
 #endif // I3D_ASTEROIDCONTANTS_H
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef I3D_BENCHMARKCONSTANTS_H
+#define I3D_BENCHMARKCONSTANTS_H
+
+unsigned int constexpr BENCHMARK_SEED = 1;
+float constexpr BENCHMARK_DT = 1.0f / 60; // fixed tick, so every run simulates the same thing
+int constexpr BENCHMARK_WARMUP_TICKS = 60; // run but not timed
+
+float constexpr BENCHMARK_THRESHOLD = 10; // % slower than the baseline that counts as a regression
+double constexpr BENCHMARK_MIN_DELTA = 0.01; // ms; ignore changes smaller than this however large in %
+
+// --stress grows the asteroid field through doubling checkpoints from
+// STRESS_FIRST_POPULATION up to the requested population, timing each one
+int constexpr STRESS_POPULATION = 10000;
+int constexpr STRESS_FIRST_POPULATION = 1000;
+int constexpr STRESS_SPAWN_RATE = 100; // most asteroids launched per tick
+int constexpr STRESS_SAMPLE_TICKS = 60; // timed per checkpoint
+double constexpr STRESS_TICK_BUDGET = 1000; // ms; a mean tick slower than this ends the run
+
+#endif
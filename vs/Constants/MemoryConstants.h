@@ -0,0 +1,10 @@
+#ifndef I3D_MEMORYCONSTANTS_H
+#define I3D_MEMORYCONSTANTS_H
+
+#include <cstddef>
+
+// Starting size of each thread's FrameArena. A frame that needs more spills
+// onto the heap, and the arena grows to fit at the next reset
+std::size_t constexpr FRAME_ARENA_CAPACITY = 256 * 1024;
+
+#endif
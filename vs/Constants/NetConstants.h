@@ -0,0 +1,18 @@
+#ifndef I3D_NETCONSTANTS_H
+#define I3D_NETCONSTANTS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Snapshot server (--server) and its clients (--connect)
+std::uint16_t constexpr NET_PORT = 47600; // when --server doesn't give one
+size_t constexpr NET_HISTORY = 64; // ticks of state kept on both ends to delta against, ~0.5 s at 120 Hz
+size_t constexpr NET_MAX_PACKET = 65507; // largest UDP payload over IPv4, so the most a receive can need
+size_t constexpr NET_FRAGMENT_SIZE = 1200; // bytes of snapshot per datagram, under the usual 1500 byte MTU
+size_t constexpr NET_MAX_FRAGMENTS = 0xffff; // a snapshot any bigger than this many isn't sent
+size_t constexpr NET_MAX_CLIENTS = 32;
+float constexpr NET_CLIENT_TIMEOUT = 5; // seconds without an ack before a server forgets a client
+float constexpr NET_HELLO_INTERVAL = 0.5f; // seconds between a client's hellos until snapshots arrive
+int constexpr NET_RECEIVE_BUFFER = 4 << 20; // bytes of socket buffer, a few keyframes' worth
+
+#endif // I3D_NETCONSTANTS_H
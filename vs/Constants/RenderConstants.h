@@ -0,0 +1,50 @@
+#ifndef I3D_RENDERCONSTANTS_H
+#define I3D_RENDERCONSTANTS_H
+
+#include <cstddef>
+
+bool constexpr RENDER_THREADED = true; // simulate on a worker thread while the GLUT thread draws
+int constexpr RENDER_ACQUIRE_TIMEOUT = 5; // ms the display callback waits for a new frame before giving up
+
+// Room made up front in each queued frame, so recording doesn't allocate
+// once warm. A busier game grows the storage once and keeps it
+size_t constexpr RENDER_FRAME_ASTEROIDS = 512;
+size_t constexpr RENDER_FRAME_BULLETS = 256;
+size_t constexpr RENDER_FRAME_EXPLOSIONS = 1024;
+size_t constexpr RENDER_FRAME_COMMANDS = RENDER_FRAME_ASTEROIDS + RENDER_FRAME_BULLETS + RENDER_FRAME_EXPLOSIONS
+	+ 16; // the ship, walls, satellite and skybox
+
+// Occlusion culling
+bool constexpr OCCLUSION_CULLING = true;
+int constexpr OCCLUSION_WIDTH = 160; // depth buffer resolution, stretched over the viewport
+int constexpr OCCLUSION_HEIGHT = 90;
+int constexpr OCCLUSION_MAX_OCCLUDERS = 24; // biggest on screen first
+float constexpr OCCLUSION_MIN_RADIUS = 135; // smallest asteroid worth rasterising
+int constexpr OCCLUSION_MAX_WORKERS = 3; // besides the render thread, also capped at the spare cores
+
+// ResourceManager
+size_t constexpr GPU_MEMORY_BUDGET = 256 << 20; // bytes of textures and buffers before it warns
+int constexpr RESOURCE_RELEASE_FRAMES = 3; // frames a released resource outlives its release without fences
+
+// Pacing for the windowed game; offscreen and benchmark runs stay unpaced
+int constexpr SWAP_INTERVAL = 1; // vertical blanks per buffer swap, 0 = vsync off
+double constexpr FRAME_RATE = 60; // display loop target (Hz) when vsync isn't there to hold it
+double constexpr TICK_RATE = 120; // simulation steps per second on the worker thread
+int constexpr PACER_SLEEP_SLICE = 1000; // us, the longest single sleep while waiting for a frame
+int constexpr PACER_SPIN_MARGIN = 2000; // us spun before a deadline until sleeps have been measured
+size_t constexpr PACER_HISTORY = 4096; // frame intervals kept for the jitter report
+
+// Performance HUD ('h' to toggle)
+size_t constexpr HUD_GRAPH_FRAMES = 120; // frame times in the graph, one line each
+int constexpr HUD_GRAPH_HEIGHT = 60; // pixels
+float constexpr HUD_GRAPH_SCALE = 33.3f; // ms at the top of the graph
+float constexpr HUD_TARGET_MS = 16.7f; // reference line across the graph
+int constexpr HUD_MARGIN = 10; // pixels from the window's top left
+int constexpr HUD_LINE_HEIGHT = 15; // GLUT_BITMAP_8_BY_13 plus spacing
+
+// --offscreen defaults
+int constexpr OFFSCREEN_WIDTH = 1280;
+int constexpr OFFSCREEN_HEIGHT = 720;
+int constexpr OFFSCREEN_FRAMES = 1000;
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef I3D_STATECONSTANTS_H
+#define I3D_STATECONSTANTS_H
+
+// State streams (--record-state / --play-state)
+int constexpr STATE_KEYFRAME_INTERVAL = 600; // ticks between full keyframes, 5 s at the 120 Hz tick
+float constexpr STATE_POSITION_STEP = 1.0f / 16; // units; positions are stored as whole steps
+float constexpr STATE_VELOCITY_STEP = 1.0f / 16; // units per second
+float constexpr STATE_ANGLE_STEP = 0.01f; // degrees
+float constexpr STATE_ROTATION_STEP = 1.0f / 32767; // quaternion components
+float constexpr STATE_TIMER_STEP = 0.001f; // seconds
+int constexpr STATE_SEEK_TICKS = 1200; // how far '[' and ']' jump during playback
+
+#endif // I3D_STATECONSTANTS_H
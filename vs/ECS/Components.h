@@ -0,0 +1,32 @@
+#ifndef I3D_COMPONENTS_H
+#define I3D_COMPONENTS_H
+
+#include "Math/Vector3D.h"
+#include "Render/RenderCommand.h"
+
+// Components shared between kinds of entity. Ones that mark what kind an
+// entity is (Ship, Asteroid, Bullet, Explosion), along with anything only
+// that kind has, live with the code that spawns them
+
+struct Position {
+	Vector3D value;
+};
+
+// Where the last systems::integrate moved it from, for sweeping its path
+struct PreviousPosition {
+	Vector3D value;
+};
+
+struct Velocity {
+	Vector3D value;
+};
+
+// A square facing the camera, drawn in the transparent pass with the
+// entity's AnimationDrawer picking the part of the texture to show
+struct Billboard {
+	Mesh mesh;
+	unsigned int texture;
+	float size;
+};
+
+#endif // I3D_COMPONENTS_H
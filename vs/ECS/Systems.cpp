@@ -0,0 +1,39 @@
+#include "Systems.h"
+#include "Components.h"
+
+#include "Animation/AnimationDrawer.h"
+#include "World/Camera.h"
+#include "Math/Matrix.h"
+
+void systems::integrate(ecs::World& world, float dt) {
+	world.each<PreviousPosition, Position>([](ecs::EntityId, PreviousPosition& previous, Position& position) {
+		previous.value = position.value;
+	});
+	world.each<Position, Velocity>([dt](ecs::EntityId, Position& position, Velocity& velocity) {
+		position.value += velocity.value * dt;
+	});
+}
+
+void systems::animate(ecs::World& world, float dt) {
+	world.each<AnimationDrawer>([&world, dt](ecs::EntityId id, AnimationDrawer& animation) {
+		animation.update(dt);
+		if (animation.hasCycled()) {
+			world.destroy(id);
+		}
+	});
+}
+
+// The transparent pass's sort keys put these back to front, so they're
+// recorded in whatever order the world has them
+void systems::recordBillboards(ecs::World& world, RenderFrame& frame) {
+	const matrix::Matrix facing = matrix::fromQuaternion(Camera::getRotation());
+	world.each<Position, Billboard, AnimationDrawer>(
+		[&frame, &facing](ecs::EntityId, Position& position, Billboard& billboard, AnimationDrawer& animation) {
+			const float size = billboard.size;
+			matrix::Matrix transform = matrix::multiply(
+				matrix::multiply(matrix::translation(position.value), facing),
+				matrix::scale(size, size, size));
+
+			frame.record(RenderPass::transparent, billboard.mesh, billboard.texture, transform, animation.getFrame());
+		});
+}
@@ -0,0 +1,19 @@
+#ifndef I3D_SYSTEMS_H
+#define I3D_SYSTEMS_H
+
+#include "World.h"
+#include "Render/RenderFrame.h"
+
+// The per-tick logic that works on components rather than kinds of entity
+namespace systems {
+	// Moves everything with a Velocity, keeping the PreviousPosition of those that have one
+	void integrate(ecs::World& world, float dt);
+
+	// Steps every AnimationDrawer, destroying the entity once a non-looping one is done
+	void animate(ecs::World& world, float dt);
+
+	// Records every Billboard, to be drawn back to front from the camera as blending needs
+	void recordBillboards(ecs::World& world, RenderFrame& frame);
+}
+
+#endif // I3D_SYSTEMS_H
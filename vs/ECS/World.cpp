@@ -0,0 +1,221 @@
+#include "World.h"
+
+#include <algorithm>
+#include <atomic>
+
+size_t ecs::nextComponentId() {
+	static std::atomic<size_t> next{ 0 };
+	return next++;
+}
+
+ecs::Archetype::Archetype(const Signature& signature)
+	: signature(signature)
+{
+	column_of.fill(-1);
+}
+
+size_t ecs::Archetype::size() const {
+	return entities.size();
+}
+
+ecs::EntityId ecs::Archetype::removeRow(size_t row) {
+	const size_t last = entities.size() - 1;
+	for (Column& column : columns) {
+		if (row != last) {
+			std::memcpy(column.data.data() + row * column.element_size,
+				column.data.data() + last * column.element_size, column.element_size);
+		}
+		column.data.resize(last * column.element_size);
+	}
+	entities[row] = entities[last];
+	entities.pop_back();
+	return row != last ? entities[row] : EntityId{ 0, 0 };
+}
+
+void ecs::Archetype::clear() {
+	for (Column& column : columns) {
+		column.data.clear();
+	}
+	entities.clear();
+}
+
+void ecs::World::destroy(EntityId id) {
+	pending.push_back(id);
+}
+
+// Anything destroyed twice is only alive for the first
+void ecs::World::flush() {
+	for (const EntityId& id : pending) {
+		if (!alive(id)) {
+			continue;
+		}
+
+		const Location location = locations[id.index];
+		const bool moved = location.row != location.archetype->size() - 1;
+		const EntityId moved_id = location.archetype->removeRow(location.row);
+		if (moved) {
+			locations[moved_id.index].row = location.row;
+		}
+		release(id);
+	}
+	pending.clear();
+}
+
+void ecs::World::clear() {
+	for (std::unique_ptr<Archetype>& archetype : archetypes) {
+		for (const EntityId& id : archetype->entities) {
+			release(id);
+		}
+		archetype->clear();
+	}
+	pending.clear();
+}
+
+// Per non-empty archetype: signature, column sizes, entities, then each column
+void ecs::World::save(Snapshot& snapshot) const {
+	size_t count = 0;
+	for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+		count += archetype->size() > 0 ? 1 : 0;
+	}
+
+	snapshot.write(count);
+	for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+		if (archetype->size() == 0) {
+			continue;
+		}
+		snapshot.write(archetype->signature.to_ullong());
+		snapshot.write(archetype->columns.size());
+		for (const Archetype::Column& column : archetype->columns) {
+			snapshot.write(column.element_size);
+		}
+		snapshot.writeVector(archetype->entities);
+		for (const Archetype::Column& column : archetype->columns) {
+			snapshot.writeVector(column.data);
+		}
+	}
+
+	snapshot.writeVector(generations);
+	snapshot.writeVector(free_indices);
+	snapshot.writeVector(pending);
+}
+
+// Archetypes not in the snapshot are left empty rather than removed, so
+// their storage is there to reuse. A snapshot that doesn't add up leaves the
+// world empty
+bool ecs::World::restore(Snapshot::Reader& reader) {
+	for (std::unique_ptr<Archetype>& archetype : archetypes) {
+		archetype->clear();
+	}
+
+	if (!restoreRows(reader)) {
+		for (std::unique_ptr<Archetype>& archetype : archetypes) {
+			archetype->clear();
+		}
+		generations.clear();
+		locations.clear();
+		free_indices.clear();
+		pending.clear();
+		return false;
+	}
+	return true;
+}
+
+bool ecs::World::restoreRows(Snapshot::Reader& reader) {
+	size_t count = 0;
+	reader.read(count);
+	for (size_t i = 0; i < count && !reader.hasFailed(); ++i) {
+		unsigned long long bits = 0;
+		size_t column_count = 0;
+		reader.read(bits);
+		reader.read(column_count);
+		const Signature signature(bits);
+		if (column_count != signature.count()) {
+			return false;
+		}
+
+		// columns are in component id order, the same as the signature's bits
+		std::array<ColumnType, MAX_COMPONENTS> types;
+		size_t column = 0;
+		for (size_t id = 0; id < MAX_COMPONENTS; ++id) {
+			if (signature.test(id)) {
+				types[column].id = id;
+				reader.read(types[column].size);
+				++column;
+			}
+		}
+
+		Archetype& archetype = findArchetype(signature, types.data(), column_count);
+		for (size_t c = 0; c < column_count; ++c) {
+			if (archetype.columns[c].element_size != types[c].size) {
+				return false;
+			}
+		}
+		reader.readVector(archetype.entities);
+		for (Archetype::Column& column : archetype.columns) {
+			reader.readVector(column.data);
+			if (column.data.size() != archetype.entities.size() * column.element_size) {
+				return false;
+			}
+		}
+	}
+
+	reader.readVector(generations);
+	reader.readVector(free_indices);
+	reader.readVector(pending);
+	if (reader.hasFailed()) {
+		return false;
+	}
+
+	locations.assign(generations.size(), { nullptr, 0 });
+	for (std::unique_ptr<Archetype>& archetype : archetypes) {
+		for (size_t row = 0; row < archetype->entities.size(); ++row) {
+			const EntityId id = archetype->entities[row];
+			if (id.index >= locations.size() || generations[id.index] != id.generation) {
+				return false;
+			}
+			locations[id.index] = { archetype.get(), row };
+		}
+	}
+	return true;
+}
+
+bool ecs::World::alive(EntityId id) const {
+	return id.index < generations.size() && generations[id.index] == id.generation;
+}
+
+ecs::Archetype& ecs::World::findArchetype(const Signature& signature, const ColumnType* types, size_t count) {
+	auto found = archetype_by_signature.find(signature.to_ullong());
+	if (found != archetype_by_signature.end()) {
+		return *found->second;
+	}
+
+	std::unique_ptr<Archetype> archetype = std::make_unique<Archetype>(signature);
+	std::vector<ColumnType> sorted(types, types + count);
+	std::sort(sorted.begin(), sorted.end(), [](const ColumnType& a, const ColumnType& b) { return a.id < b.id; });
+	for (const ColumnType& type : sorted) {
+		archetype->column_of[type.id] = static_cast<int>(archetype->columns.size());
+		archetype->columns.push_back({ type.size, {} });
+	}
+
+	Archetype& result = *archetype;
+	archetype_by_signature[signature.to_ullong()] = archetype.get();
+	archetypes.push_back(std::move(archetype));
+	return result;
+}
+
+ecs::EntityId ecs::World::allocate() {
+	if (!free_indices.empty()) {
+		const std::uint32_t index = free_indices.back();
+		free_indices.pop_back();
+		return { index, generations[index] };
+	}
+
+	generations.push_back(0);
+	locations.push_back({ nullptr, 0 });
+	return { static_cast<std::uint32_t>(generations.size() - 1), 0 };
+}
+
+void ecs::World::release(EntityId id) {
+	++generations[id.index];
+	free_indices.push_back(id.index);
+}
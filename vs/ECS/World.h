@@ -0,0 +1,199 @@
+#ifndef I3D_WORLD_H
+#define I3D_WORLD_H
+
+#include "State/Snapshot.h"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace ecs {
+	size_t constexpr MAX_COMPONENTS = 32;
+
+	using Signature = std::bitset<MAX_COMPONENTS>;
+
+	// index picks the slot, generation tells a live entity from an earlier one
+	// that had the same slot
+	struct EntityId {
+		std::uint32_t index;
+		std::uint32_t generation;
+	};
+
+	inline bool operator==(EntityId a, EntityId b) {
+		return a.index == b.index && a.generation == b.generation;
+	}
+
+	inline bool operator!=(EntityId a, EntityId b) {
+		return !(a == b);
+	}
+
+	size_t nextComponentId();
+
+	// Each component type gets a number the first time it's used
+	template <typename T>
+	size_t componentId() {
+		static const size_t id = nextComponentId();
+		return id;
+	}
+
+	// All the entities with exactly one set of components, each component kept
+	// in its own tightly packed column so systems walk memory in order. Rows
+	// line up across the columns and with entities
+	class Archetype {
+	public:
+		explicit Archetype(const Signature& signature);
+
+		template <typename T>
+		T* column() {
+			return reinterpret_cast<T*>(columns[column_of[componentId<T>()]].data.data());
+		}
+
+		size_t size() const;
+
+		// Moves the last row into row, returning the entity that was moved
+		EntityId removeRow(size_t row);
+		void clear();
+
+	private:
+		friend class World;
+
+		struct Column {
+			size_t element_size;
+			std::vector<unsigned char> data;
+		};
+
+		Signature signature;
+		std::array<int, MAX_COMPONENTS> column_of; // -1 where there's no such component
+		std::vector<Column> columns;
+		std::vector<EntityId> entities;
+	};
+
+	// Owns every entity and its components. Components are plain data (they
+	// have to be trivially copyable, so rows can be moved about with memcpy)
+	// and an entity's set of them is fixed when it's created.
+	//
+	// destroy() only queues the entity up; flush() removes the whole queue at
+	// once at a point where nothing is iterating. Creating entities inside
+	// each() is fine as long as they don't have the same components as the
+	// ones being visited, which could move the columns under the loop.
+	class World {
+	public:
+		template <typename... Components>
+		EntityId create(const Components&... components) {
+			static_assert((std::is_trivially_copyable_v<Components> && ...),
+				"components are copied about with memcpy");
+
+			Signature signature;
+			(signature.set(componentId<Components>()), ...);
+			const ColumnType types[] = { { componentId<Components>(), sizeof(Components) }... };
+			Archetype& archetype = findArchetype(signature, types, sizeof...(Components));
+
+			const EntityId id = allocate();
+			locations[id.index] = { &archetype, archetype.size() };
+			archetype.entities.push_back(id);
+			(append(archetype, components), ...);
+			return id;
+		}
+
+		void destroy(EntityId id);
+		void flush();
+		void clear(); // everything, right away
+
+		// Every archetype's rows, and the slots and generations behind the
+		// entity ids, so ids held from before a save are alive after a restore
+		// exactly when they were at the save. Archetypes are matched up by
+		// their components, which are numbered per process
+		void save(Snapshot& snapshot) const;
+		bool restore(Snapshot::Reader& reader);
+
+		bool alive(EntityId id) const;
+
+		template <typename T>
+		T* get(EntityId id) {
+			if (!alive(id)) {
+				return nullptr;
+			}
+			const Location& location = locations[id.index];
+			if (!location.archetype->signature.test(componentId<T>())) {
+				return nullptr;
+			}
+			return location.archetype->column<T>() + location.row;
+		}
+
+		// Calls function(EntityId, Components&...) for every entity that has at
+		// least those components, archetype by archetype in creation order
+		template <typename... Components, typename Function>
+		void each(Function&& function) {
+			Signature required;
+			(required.set(componentId<Components>()), ...);
+
+			// by index, since the function may add archetypes
+			for (size_t i = 0; i < archetypes.size(); ++i) {
+				Archetype& archetype = *archetypes[i];
+				if ((archetype.signature & required) != required || archetype.size() == 0) {
+					continue;
+				}
+
+				const std::tuple<Components*...> columns(archetype.column<Components>()...);
+				const size_t count = archetype.size();
+				for (size_t row = 0; row < count; ++row) {
+					function(archetype.entities[row], std::get<Components*>(columns)[row]...);
+				}
+			}
+		}
+
+		template <typename... Components>
+		size_t count() const {
+			Signature required;
+			(required.set(componentId<Components>()), ...);
+
+			size_t total = 0;
+			for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+				if ((archetype->signature & required) == required) {
+					total += archetype->size();
+				}
+			}
+			return total;
+		}
+
+	private:
+		struct Location {
+			Archetype* archetype;
+			size_t row;
+		};
+
+		struct ColumnType {
+			size_t id;
+			size_t size;
+		};
+
+		Archetype& findArchetype(const Signature& signature, const ColumnType* types, size_t count);
+		bool restoreRows(Snapshot::Reader& reader);
+		EntityId allocate();
+		void release(EntityId id);
+
+		template <typename T>
+		void append(Archetype& archetype, const T& component) {
+			std::vector<unsigned char>& data = archetype.columns[archetype.column_of[componentId<T>()]].data;
+			const size_t offset = data.size();
+			data.resize(offset + sizeof(T));
+			std::memcpy(data.data() + offset, &component, sizeof(T));
+		}
+
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		std::map<unsigned long long, Archetype*> archetype_by_signature;
+
+		std::vector<std::uint32_t> generations; // by index
+		std::vector<Location> locations; // by index, only meaningful while alive
+		std::vector<std::uint32_t> free_indices;
+		std::vector<EntityId> pending; // destroyed but not yet flushed
+	};
+}
+
+#endif // I3D_WORLD_H
@@ -2,31 +2,19 @@
 #define I3D_EXPLOSION_H
 
 #include "Constants/ExplosionConstants.h"
-#include "Transparent/Transparent.h"
-#include "Animation/AnimationDrawer.h"
+#include "ECS/World.h"
 #include "Math/Vector3D.h"
 
-#include <array>
-#include <utility>
+// Marks the entities that are explosion particles. Besides this they have a
+// Position, Velocity, Billboard and an AnimationDrawer that plays once, after
+// which systems::animate destroys them
+struct Explosion {};
 
-class Explosion : public Transparent {
-public:
-	Explosion(Vector3D position, Vector3D velocity);
+namespace explosion {
+	ecs::EntityId spawn(ecs::World& world, const Vector3D& position, const Vector3D& velocity);
 
-	void update(float dt);
-	void draw() const override;
+	// A burst of EXPLOSION_NUMBER particles flying out from position
+	void populate(ecs::World& world, const Vector3D& position);
+}
 
-	const Vector3D& getPosition() const override;
-
-	void markForDeletion();
-	bool markedForDeletion() const;
-
-private:
-	AnimationDrawer animation;
-
-	Vector3D position;
-	Vector3D velocity;
-	bool to_delete;
-};
-
-#endif // I3D_EXPLOSION_H
\ No newline at end of file
+#endif // I3D_EXPLOSION_H
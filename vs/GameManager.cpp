@@ -5,30 +5,204 @@
 #include "GlutHeaders.h"
 #include "Math/Utility.h"
 
-#include "Transparent/Transparent.h"
+#include "ECS/Systems.h"
+#include "ECS/Components.h"
+#include "Bullets/Bullet.h"
+#include "Explosion/Explosion.h"
+#include "Animation/AnimationDrawer.h"
 
 #include "Collisions/Collision.h"
 
 #include "Assets/Asset.h"
+#include "Assets/ResourceManager.h"
 
+#include "Constants/RenderConstants.h"
+#include "Constants/StateConstants.h"
+#include "Constants/BenchmarkConstants.h"
+#include "Constants/AsteroidConstants.h"
+
+#include "Profiling/Profiler.h"
+#include "Memory/FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 
+namespace {
+	// Bump whenever anything's save() changes what it writes
+	std::uint32_t constexpr SNAPSHOT_VERSION = 2;
+
+	// One core for the simulation and one for the renderer, any others can
+	// help solve contacts
+	int solverWorkers() {
+		const int spare = static_cast<int>(std::thread::hardware_concurrency()) - 2;
+		return std::clamp(spare, 0, CONTACT_SOLVER_MAX_WORKERS);
+	}
+
+	// Every kind of entity shares the world, so its ids are unique as they are
+	std::uint64_t stateId(ecs::EntityId id) {
+		return static_cast<std::uint64_t>(id.generation) << 32 | id.index;
+	}
+
+	EntityState asteroidState(ecs::EntityId id, const Asteroid& asteroid, const Position& position, const Velocity& velocity) {
+		EntityState state = {};
+		state.id = stateId(id);
+		state.kind = EntityKind::asteroid;
+		state.position = position.value;
+		state.velocity = velocity.value;
+		state.angle = asteroid.angle;
+		state.health = asteroid.health;
+		state.in_arena = asteroid.in_arena;
+		state.radius = asteroid.radius;
+		state.seed = asteroid.seed;
+		state.texture_layer = asteroid.texture_layer;
+		state.rotation_axis = asteroid.rotation_axis;
+		state.rotation_speed = asteroid.rotation_speed;
+		state.rotation_direction = asteroid.rotation_direction;
+		return state;
+	}
+
+	EntityState billboardState(ecs::EntityId id, EntityKind kind,
+		const Position& position, const Velocity& velocity, const AnimationDrawer& animation) {
+		EntityState state = {};
+		state.id = stateId(id);
+		state.kind = kind;
+		state.position = position.value;
+		state.velocity = velocity.value;
+		state.frame = animation.getFrameIndex();
+		return state;
+	}
+}
+
 GameManager::GameManager() :
 	dt(0),
-	last_time(0),
-	ship(std::make_unique<Ship>()),
+	last_time(std::chrono::steady_clock::now()),
+	threaded(RENDER_THREADED),
+	headless(false),
+	fixed_dt(0),
+	ship_invulnerable(false),
+	occlusion_culling(OCCLUSION_CULLING),
+	running(false),
+	finished(false),
+	render_queue(std::make_unique<RenderQueue>()),
+	playback_speed(1),
+	playback_ticks(0),
+	seek_ticks(0),
 	keyboard(std::make_unique<Keyboard>()),
 	mouse(std::make_unique<Mouse>()),
 	window(std::make_unique<Window>()),
 	camera(std::make_unique<Camera>()),
 	arena(std::make_unique<Arena>()),
 	asteroid_field(std::make_unique<AsteroidField>()),
-	explosion_manager(std::make_unique<ExplosionManager>()) {}
+	world(std::make_unique<ecs::World>()),
+	ship(ship::create(*world)),
+	contact_solver(solverWorkers()),
+	quick_save_held(false),
+	quick_load_held(false) {}
+
+GameManager::~GameManager() {
+	stop();
+}
 
+// The GLUT thread owns the context, so it stays in glutMainLoop drawing
+// whatever was last published while the simulation ticks on its own thread
 void GameManager::start() {
 	init();
+	startSimulation();
+
 	glutMainLoop();
+	stop();
+
+	display_pacer.report(std::cout, "Display pacing");
+	tick_pacer.report(std::cout, "Tick pacing");
+	if (state_recorder) {
+		state_recorder->report(std::cout);
+	}
+	if (snapshot_client) {
+		snapshot_client->report(std::cout);
+	}
+}
+
+// Stand-in for glutMainLoop when there's no window, e.g. an Offscreen context.
+// Draws frame_count frames through the same onDisplay path, or fewer if a
+// replay ends first, and returns how many it drew
+int GameManager::run(int frame_count) {
+	init();
+	startSimulation();
+
+	int frames = 0;
+	while (frames < frame_count && !finished) {
+		if (!threaded) {
+			tick();
+		}
+		if (onDisplay()) {
+			++frames;
+		}
+	}
+
+	stop();
+	if (state_recorder) {
+		state_recorder->report(std::cout);
+	}
+	if (snapshot_client) {
+		snapshot_client->report(std::cout);
+	}
+	return frames;
+}
+
+// Stand-in for glutMainLoop on a server, which has no window or context to
+// draw with, nor anything to draw. Ticks at the tick rate for tick_count
+// ticks, or until finish() if that's 0, and returns how many it ran. A
+// population keeps the field topped up to that many asteroids, for soaking
+int GameManager::serve(int tick_count, int population) {
+	int ticks = 0;
+	while ((tick_count == 0 || ticks < tick_count) && !finished) {
+		const int missing = population - static_cast<int>(world->count<Asteroid>());
+		if (missing > 0) {
+			asteroid_field->launchAsteroidsAt(*world, Vector3D(), std::min(missing, STRESS_SPAWN_RATE));
+		}
+		tick();
+		tick_pacer.wait();
+		++ticks;
+	}
+
+	tick_pacer.report(std::cout, "Tick pacing");
+	if (state_recorder) {
+		state_recorder->report(std::cout);
+	}
+	if (snapshot_server) {
+		snapshot_server->report(std::cout);
+	}
+	return ticks;
+}
+
+void GameManager::finish() {
+	finished = true;
+	running = false;
+}
+
+void GameManager::startSimulation() {
+	if (!threaded) {
+		return;
+	}
+
+	running = true;
+	simulation = std::thread([this] {
+		while (running) {
+			tick();
+			tick_pacer.wait();
+		}
+	});
+}
+
+void GameManager::stop() {
+	running = false;
+	render_queue->stop();
+	if (simulation.joinable()) {
+		simulation.join();
+	}
 }
 
 void GameManager::init() {
@@ -62,61 +236,243 @@ void GameManager::init() {
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	renderer = std::make_unique<Renderer>();
+	renderer->setOcclusionCulling(occlusion_culling);
 }
 
+// When replaying, dt and input come from the recording rather than the clock
+// and the callbacks; when recording, the input is written out exactly as it's
+// about to be handled. Playing a state stream, or following a server, skips
+// the simulation entirely
+void GameManager::tick() {
+	if (finished) {
+		return;
+	}
 
+	Profiler::Scope tick_scope(Phase::tick);
+	const auto tick_start = std::chrono::steady_clock::now();
+	const AllocationTracker::Counts tick_counts = AllocationTracker::current();
 
-// Draw everything
-void GameManager::onDisplay() {
-	updateCamera();
+	if (state_player) {
+		if (!playState()) {
+			return;
+		}
+	}
+	else if (snapshot_client) {
+		followServer();
+	}
+	else {
+		if (input_replayer) {
+			if (!input_replayer->read(replay_input)) {
+				std::cout << "Replay finished" << std::endl;
+				finished = true;
+				running = false;
+				return;
+			}
+			dt = replay_input.dt;
+		}
+		else if (fixed_dt > 0) {
+			dt = fixed_dt;
+		}
+		else {
+			calculateTimeDelta();
+		}
 
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glEnable(GL_DEPTH_TEST);
-	glMatrixMode(GL_MODELVIEW);
+		{
+			Profiler::Scope scope(Phase::update);
+			updateEntities();
+		}
+		{
+			Profiler::Scope scope(Phase::collisions);
+			handleCollisions();
+		}
+		{
+			Profiler::Scope scope(Phase::input);
+			std::lock_guard<std::mutex> lock(input_mutex);
+			if (input_replayer) {
+				applyInput(replay_input);
+			}
+			else if (input_recorder) {
+				input_recorder->write(captureInput());
+			}
+			handleKeyboardInput();
+			handleMouseInput();
+		}
 
-	// Update camera and draw skybox
-	glLoadIdentity();
-	camera->rotate();
-	arena->drawSkybox();
-	camera->translate();
+		removeMarked();
+	}
 
-	float position0[] = { 1.0, 0.0, 0.0, 0.0 };
-	glLightfv(GL_LIGHT0, GL_POSITION, position0);
+	const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - tick_start;
+	if (snapshot_server) {
+		// nothing's drawn, but the clients still want the camera following the ship
+		updateCamera();
+	}
+	else {
+		RenderFrame& frame = render_queue->back();
+		frame.stats.tick_ms = elapsed.count();
+		frame.stats.allocations = AllocationTracker::current().allocations - tick_counts.allocations;
+		frame.stats.asteroids = static_cast<std::uint32_t>(world->count<Asteroid>());
+		frame.stats.bullets = static_cast<std::uint32_t>(world->count<Bullet>());
+		frame.stats.explosions = static_cast<std::uint32_t>(world->count<Explosion>());
+
+		{
+			Profiler::Scope scope(Phase::record);
+			record(frame);
+		}
+		render_queue->publish();
+	}
+
+	// after record, which moves the camera on
+	if (state_recorder || snapshot_server) {
+		captureState(world_state);
+	}
+	if (state_recorder) {
+		state_recorder->write(world_state);
+	}
+	if (snapshot_server) {
+		snapshot_server->update(world_state, elapsed.count());
+	}
+
+	FrameArena::local().reset();
+}
+
+// Reads as many recorded ticks as the playback speed has built up and shows
+// the last. At the end of the stream it checks for more being written, and
+// otherwise holds the last state in a window or finishes offscreen
+bool GameManager::playState() {
+	const long long seek = seek_ticks.exchange(0);
+	if (seek != 0) {
+		const long long target = static_cast<long long>(state_player->getTick()) + seek;
+		state_player->seek(static_cast<std::uint64_t>(std::max(0LL, target)));
+	}
+
+	playback_ticks += playback_speed;
+	bool played = false;
+	while (playback_ticks >= 1) {
+		playback_ticks -= 1;
+		if (!state_player->read(world_state)) {
+			state_player->refresh();
+			if (!state_player->read(world_state)) {
+				playback_ticks = 0;
+				break;
+			}
+		}
+		played = true;
+	}
+
+	if (played) {
+		dt = world_state.dt;
+		applyState(world_state);
+	}
+	else if (headless && state_player->getTick() >= state_player->getTickCount()) {
+		std::cout << "State playback finished" << std::endl;
+		finished = true;
+		running = false;
+		return false;
+	}
+	return true;
+}
+
+// Shows the newest snapshot the server's sent, if one's come since last tick
+void GameManager::followServer() {
+	if (snapshot_client->poll(world_state)) {
+		dt = world_state.dt;
+		applyState(world_state);
+	}
+}
+
+// Snapshot everything visible into the frame. Runs on the simulation thread,
+// so no GL calls in here or in anything it records
+void GameManager::record(RenderFrame& frame) {
+	AllocationTracker::SteadyState steady_state("record");
+
+	// a state stream or a server brings the camera with it
+	if (!state_player && !snapshot_client) {
+		updateCamera();
+	}
+
+	// If we want to look up, then we rotate the world down, so we need the
+	// camera's inverse quaternion
+	frame.view_rotation = matrix::fromQuaternion(Quaternion::inverse(Camera::getRotation()));
+	frame.camera_position = camera->getPosition();
+
+	ship::record(*world, frame);
+
+	arena->recordArena(frame);
+	arena->recordSatellite(frame);
+	asteroid::record(*world, frame);
+
+	// Skybox is its own pass after the opaque objects so it's only shaded where
+	// they left gaps, but before the transparent ones so they can blend over it
+	arena->recordSkybox(frame);
+
+	systems::recordBillboards(*world, frame); // bullets and explosions (if any)
+}
 
-	// Drawing scene objects
-	ship->draw();
+// Draw the latest frame, if the simulation has published one since last time.
+// Returns whether anything was drawn
+bool GameManager::onDisplay() {
+	RenderFrame* frame = render_queue->acquire(RENDER_ACQUIRE_TIMEOUT);
+	if (frame == nullptr) {
+		return false;
+	}
 
-	arena->drawArena();
-	arena->drawSatellite();
-	asteroid_field->drawAsteroids();
+	Profiler::Scope scope(Phase::render);
 
-	Transparent::drawAll(); // draws bullets and explosions (if any)
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glEnable(GL_DEPTH_TEST);
+
+	const auto render_start = std::chrono::steady_clock::now();
+	const AllocationTracker::Counts render_counts = AllocationTracker::current();
+	renderer->execute(*frame);
+	const std::chrono::duration<double, std::milli> render_elapsed = std::chrono::steady_clock::now() - render_start;
+	hud.update(frame->stats, renderer->getStats(), render_elapsed.count(),
+		AllocationTracker::current().allocations - render_counts.allocations);
+	render_queue->release();
+	FrameArena::local().reset();
+
+	// GLUT's fonts need glutInit, which offscreen runs never call
+	if (!headless) {
+		hud.draw();
+	}
 
 	int err;
 	while ((err = glGetError()) != GL_NO_ERROR)
 		printf("display: %s\n", gluErrorString(err));
 
-	glutSwapBuffers();
+	// Nothing to swap offscreen, but wait for the frame so it's fully counted
+	if (headless) {
+		glFinish();
+	}
+	else {
+		glutSwapBuffers();
+	}
+	ResourceManager::collect();
+	return true;
 }
 
-// Calculations and updates that occur in the background
+// Without the simulation thread, updates happen here in between draws. The
+// pacer holds off the next redisplay until it's due, which is what keeps
+// GLUT's idle loop from running flat out
 void GameManager::onIdle() {
-	calculateTimeDelta();
-
-	updateEntities();
-	handleCollisions();
-	
-	handleKeyboardInput();
-	handleMouseInput();
+	if (!threaded) {
+		tick();
+	}
+	display_pacer.wait();
+	glutPostRedisplay();
 }
 
 void GameManager::onReshape(const int w, const int h) {
-	window->width = w;
-	window->height = h;
-
 	const float aspect_ratio = static_cast<float>(w) / static_cast<float>(h);
 
-	camera->setAspect(aspect_ratio);
+	// a replay brings its own window size along with the mouse
+	if (!input_replayer) {
+		std::lock_guard<std::mutex> lock(input_mutex);
+		window->width = w;
+		window->height = h;
+		camera->setAspect(aspect_ratio);
+	}
 
 	glViewport(0, 0, w, h);
 
@@ -136,207 +492,315 @@ void GameManager::onReshape(const int w, const int h) {
 //	M: The camera moves below the ship and looks above it
 
 void GameManager::updateCamera() {
+	const Quaternion& ship_rotation = world->get<Ship>(ship)->rotation;
+	const Vector3D& ship_position = world->get<Position>(ship)->value;
 	Vector3D position;
 	Quaternion rotation;
 
 	if (camera->look_at == Look::AHEAD) {
-		rotation = ship->getRotation();
-		position = ship->getPosition() + camera->distanceFromShip() * (ship->getRotation() * Vector3D::forward());
+		rotation = ship_rotation;
+		position = ship_position + camera->distanceFromShip() * (ship_rotation * Vector3D::forward());
 	}
 	else if (camera->look_at == Look::LEFT) {
-		rotation = ship->getRotation() * Quaternion(Vector3D::up(), -90);
-		position = ship->getPosition() + camera->distanceFromShip() * (ship->getRotation() * Vector3D::right());
+		rotation = ship_rotation * Quaternion(Vector3D::up(), -90);
+		position = ship_position + camera->distanceFromShip() * (ship_rotation * Vector3D::right());
 	}
 	else if (camera->look_at == Look::RIGHT) {
-		rotation = ship->getRotation() * Quaternion(Vector3D::up(), 90);
-		position = ship->getPosition() - camera->distanceFromShip() * (ship->getRotation() * Vector3D::right());
+		rotation = ship_rotation * Quaternion(Vector3D::up(), 90);
+		position = ship_position - camera->distanceFromShip() * (ship_rotation * Vector3D::right());
 	}
 	else if (camera->look_at == Look::BEHIND) {
-		rotation = ship->getRotation() * Quaternion(Vector3D::up(), 180);
-		position = ship->getPosition() - camera->distanceFromShip() * (ship->getRotation() * Vector3D::forward());
+		rotation = ship_rotation * Quaternion(Vector3D::up(), 180);
+		position = ship_position - camera->distanceFromShip() * (ship_rotation * Vector3D::forward());
 	}
 	else if (camera->look_at == Look::ABOVE) {
-		rotation = ship->getRotation() * Quaternion(Vector3D::right(), -90);
-		position = ship->getPosition() - camera->distanceFromShip() * (ship->getRotation() * Vector3D::up());
+		rotation = ship_rotation * Quaternion(Vector3D::right(), -90);
+		position = ship_position - camera->distanceFromShip() * (ship_rotation * Vector3D::up());
 	}
 	else if (camera->look_at == Look::BELOW) {
-		rotation = ship->getRotation() * Quaternion(Vector3D::right(), 90);
-		position = ship->getPosition() + camera->distanceFromShip() * (ship->getRotation() * Vector3D::up());
+		rotation = ship_rotation * Quaternion(Vector3D::right(), 90);
+		position = ship_position + camera->distanceFromShip() * (ship_rotation * Vector3D::up());
 	}
 
 	// raise the position of the camera slightly up
-	position += 10.0f * (ship->getRotation() * Vector3D::up());
+	position += 10.0f * (ship_rotation * Vector3D::up());
 
 	camera->lerpPositionTo(position);
 	camera->lerpRotationTo(rotation);
-
-	glutPostRedisplay();
 }
 
 void GameManager::updateEntities() {
-	Transparent::sort(camera->getPosition()); // sort transparent entities after updating everything
 	updateShip();
+	updateWorld();
 	updateAsteroids();
-	updateBullets();
 	updateSatellite();
-	updateExplosions();
 }
 
 void GameManager::updateShip() {
-	ship->update(dt);
+	ship::update(*world, dt);
 }
 
 void GameManager::updateAsteroids() {
-	asteroid_field->updateAsteroids(dt);
+	asteroid_field->update(dt);
 
-	if (asteroid_field->isEmpty() || asteroid_field->levellingUp()) {
+	const bool empty = world->count<Asteroid>() == 0;
+	if (empty || asteroid_field->levellingUp()) {
 		// Reset timer if empty to prevent two waves spawning back to back
-		if (asteroid_field->isEmpty()) {
+		if (empty) {
 			asteroid_field->resetTimer();
 		}
 		asteroid_field->increaseAsteroidCountBy(1);
-		asteroid_field->launchAsteroidsAtShip(ship->getPosition());
+		asteroid_field->launchAsteroidsAtShip(*world, world->get<Position>(ship)->value);
 	}
 }
 
-void GameManager::updateBullets() {
-	ship->updateBullets(dt);
-}
-
 void GameManager::updateSatellite() {
 	arena->updateSatellite(dt);
 }
 
-void GameManager::updateExplosions() {
-	explosion_manager->updateExplosions(dt);
+// Asteroids, bullets and explosions
+void GameManager::updateWorld() {
+	systems::integrate(*world, dt);
+	asteroid::update(*world, dt);
+	systems::animate(*world, dt);
 }
 
+// Whatever was destroyed this tick goes all at once, before it's recorded, so
+// nothing is removed out from under a loop over it
+void GameManager::removeMarked() {
+	world->flush();
+}
+
+// Everything that can reach the walls is tested against them together first:
+// the ship (at both its radii), then the asteroids, then the bullets. The
+// asteroids are gathered once, so the rest of the tick's collisions can look
+// them up by their place in the batch and pair them off by index
 void GameManager::handleCollisions() {
-	handleWallCollisions();
-	handleBulletCollisions();
-	handleAsteroidCollisions();
+	ContactBodies asteroids;
+	asteroids.reserve(world->count<Asteroid, Position, Velocity>());
+	world->each<Asteroid, Position, Velocity>(
+		[&asteroids](ecs::EntityId id, Asteroid& asteroid, Position& position, Velocity& velocity) {
+			asteroids.push_back({ id, &asteroid, &position, &velocity });
+		});
+
+	const Ship& ship_state = *world->get<Ship>(ship);
+	const Vector3D& ship_position = world->get<Position>(ship)->value;
+
+	WallBatch walls;
+	walls.reserve(2 + asteroids.size() + world->count<Bullet, PreviousPosition, Position>());
+	const size_t ship_warning = walls.add(ship_position, ship_state.warning_radius);
+	const size_t ship_collision = walls.add(ship_position, ship_state.collision_radius);
+	const size_t first_asteroid = ship_collision + 1;
+	for (const ContactBody& body : asteroids) {
+		walls.add(body.position->value, body.asteroid->radius);
+	}
+	// The same rows, in the same order, as handleBulletCollisions visits
+	const size_t first_bullet = first_asteroid + asteroids.size();
+	world->each<Bullet, PreviousPosition, Position>([&walls](ecs::EntityId, Bullet&, PreviousPosition&, Position& position) {
+		walls.add(position.value, 0);
+	});
+	walls.run();
+
+	// A crash empties the field and the ship's bullets, so there's nothing
+	// left to look up
+	if (handleWallCollisions(walls.getMask(ship_warning), walls.getMask(ship_collision))) {
+		return;
+	}
+	handleBulletCollisions(asteroids, walls, first_bullet);
+	handleAsteroidCollisions(asteroids, walls, first_asteroid);
 }
 
 // Ship -> Wall
-void GameManager::handleWallCollisions() {
+// Returns whether the ship crashed, resetting the game
+bool GameManager::handleWallCollisions(unsigned char warning_mask, unsigned char collision_mask) {
 	for (Wall& wall : arena->getWalls()) {
-		if (collision::withWall(wall, ship->getPosition(), ship->getWarningRadius())) {
-			wall.setColour(Colour::RED);
-		}
-		else {
-			wall.setColour(Colour::WHITE);
-		}
+		wall.setColour(warning_mask & collision::wallBit(wall) ? Colour::RED : Colour::WHITE);
+	}
 
-		if (collision::withWall(wall, ship->getPosition(), ship->getCollisionRadius())) {
-			resetGame();
-			break;
-		}
+	if (collision_mask != 0) {
+		resetGame();
+		return true;
 	}
+	return false;
 }
 
 // Asteroid -> Ship
 // Asteroid -> Wall
 // Asteroid -> Asteroid
-void GameManager::handleAsteroidCollisions() {
-	for (Asteroid& a1 : asteroid_field->getAsteroids()) {
-		if (!a1.isInArena()) {
-			continue;
-		}
-
-		if (collision::withAsteroid(a1.getPosition(), a1.getRadius(), ship->getPosition(), ship->getCollisionRadius())) {
-			// Persist ship explosions after resetting the game
-			Vector3D ship_position = ship->getPosition();
-			resetGame();
-			explosion_manager->populate(ship_position);
-		}
+void GameManager::handleAsteroidCollisions(ContactBodies& asteroids, const WallBatch& walls, size_t first) {
+	contact_cache.begin(asteroids, dt);
+	contact_solver.clear();
+
+	const Vector3D ship_position = world->get<Position>(ship)->value;
+	const float ship_radius = world->get<Ship>(ship)->collision_radius;
+	for (size_t i = 0; i < asteroids.size(); ++i) {
+		const ContactBody& a1 = asteroids[i];
+
+		if (a1.asteroid->in_arena) {
+			if (!ship_invulnerable
+				&& collision::withAsteroid(a1.position->value, a1.asteroid->radius, ship_position, ship_radius)) {
+				// Persist ship explosions after resetting the game
+				resetGame();
+				explosion::populate(*world, ship_position);
+				return; // no asteroids left to test
+			}
 
-		for (const Wall& wall : arena->getWalls()) {
-			if (collision::withWall(wall, a1.getPosition(), a1.getRadius())) {
-				collision::resolve(wall, a1);
+			// Pairs aren't solved until they've all been found, so nothing
+			// has moved a1 since the batch was filled
+			const unsigned char wall_mask = walls.getMask(first + i);
+			if (wall_mask != 0) {
+				for (const Wall& wall : arena->getWalls()) {
+					if (wall_mask & collision::wallBit(wall)) {
+						collision::resolve(wall, *a1.position, *a1.velocity);
+					}
+				}
+				contact_cache.invalidate(i);
 			}
 		}
 
 		// ASTEROID->ASTEROID COLLISIONS ///////////////////////////
-		for (Asteroid& a2 : asteroid_field->getAsteroids()) {
-			if (a1.id() != a2.id()) {
-				if (collision::withAsteroid(a1.getPosition(), a1.getRadius(), a2.getPosition(), a2.getRadius())) {
-					// Calculate new velocities, then move slightly apart
-					collision::resolve(a1, a2);
-					a1.update(dt);
-					a2.update(dt);
-				}
+		// Each pair once, as long as one of them has made it into the arena.
+		// Against the earlier asteroids, which is the order the cache stores them
+		for (size_t j = 0; j < i; ++j) {
+			const ContactBody& a2 = asteroids[j];
+			if (!a1.asteroid->in_arena && !a2.asteroid->in_arena) {
+				continue;
+			}
+
+			if (contact_cache.withAsteroid(j, i, a2, a1)) {
+				contact_solver.add(j, i);
 			}
 		}
 	}
+
+	contact_solver.solve(asteroids, contact_cache);
 }
 
 // Bullet -> Wall
 // Bullet -> Asteroid
-void GameManager::handleBulletCollisions() {
-	for (std::shared_ptr<Bullet>& bullet : ship->getBullets()) {
-		// Bullet->Wall
-		for (Wall& wall : arena->getWalls()) {
-			if (collision::withWall(wall, bullet->getPosition())) {
-				bullet->markForDeletion();
+// Bullets cover a lot of ground in a tick, so test the whole path they took
+// and only the first thing along it gets hit
+// Visits bullets in the same order handleCollisions added them to the batch,
+// as the last of it
+void GameManager::handleBulletCollisions(const ContactBodies& asteroids, const WallBatch& walls, size_t first) {
+	size_t index = first;
+	world->each<Bullet, PreviousPosition, Position>(
+		[this, &asteroids, &walls, &index](ecs::EntityId id, Bullet&, PreviousPosition& previous, Position& position) {
+			const Vector3D& start = previous.value;
+			const Vector3D& end = position.value;
+			float first_hit = 2; // past the end of the path
+			float time;
+
+			// Bullet->Wall
+			// Bullets start inside, so only a wall they've ended up past can be on the path
+			const unsigned char wall_mask = walls.getMask(index++);
+			for (const Wall& wall : arena->getWalls()) {
+				if ((wall_mask & collision::wallBit(wall)) && collision::sweepWall(wall, start, end, time)) {
+					first_hit = std::min(first_hit, time);
+				}
 			}
-		}
 
-		// Why check asteroids if bullet died on a wall?
-		if (bullet->markedForDeletion()) {
-			continue;
-		}
+			const ContactBody* hit = nullptr;
+			for (const ContactBody& asteroid : asteroids) {
+				if (asteroid.asteroid->health <= 0) {
+					continue; // already destroyed this tick
+				}
+				if (collision::sweepAsteroid(asteroid.position->value, asteroid.asteroid->radius, start, end, time) && time < first_hit) {
+					first_hit = time;
+					hit = &asteroid;
+				}
+			}
 
-		for (Asteroid& asteroid : asteroid_field->getAsteroids()) {
-			if (collision::withAsteroid(asteroid.getPosition(), asteroid.getRadius(), bullet->getPosition())) {
-				bullet->markForDeletion();
-				asteroid.decrementHealthBy(1);
-				if (asteroid.getHealth() <= 0) {
-					explosion_manager->populate(asteroid.getPosition());
+			if (first_hit > 1) {
+				return;
+			}
+			world->destroy(id);
+			if (hit != nullptr) {
+				hit->asteroid->health -= 1;
+				if (hit->asteroid->health <= 0) {
+					world->destroy(hit->id);
+					explosion::populate(*world, hit->position->value);
 				}
-				break;
 			}
-		}
-	}
+	});
+	assert(index == walls.size());
 }
 
 // glutKeyboardFunc(keyboardDownCallback);
 void GameManager::onKeyDown(const unsigned char key, int x, int y) {
+	// The HUD is drawn on this thread, and isn't game input so works in replays too
+	if (key == 'h') {
+		hud.toggle();
+		return;
+	}
+	if (state_player) {
+		if (key == '[') {
+			seek_ticks -= STATE_SEEK_TICKS;
+		}
+		else if (key == ']') {
+			seek_ticks += STATE_SEEK_TICKS;
+		}
+		return;
+	}
+	if (input_replayer) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(input_mutex);
 	keyboard->setPressed(key, true);
 }
 
 // glutKeyboardUpFunc(keyboardUpCallback);
 void GameManager::onKeyUp(const unsigned char key, int x, int y) {
+	if (input_replayer) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(input_mutex);
 	keyboard->setPressed(key, false);
 }
 
+// The ship's components are only held onto until the keys that reset or
+// restore the world, which make it again
 void GameManager::handleKeyboardInput() {
+	Ship& ship_state = *world->get<Ship>(ship);
+	Position& ship_position = *world->get<Position>(ship);
 
 	if (keyboard->isPressed('w')) {
-		ship->move(Direction::forward, dt);
+		ship::move(ship_state, ship_position, Direction::forward, dt);
 	}
 	else if (keyboard->isPressed('s')) {
-		ship->move(Direction::backward, dt);
+		ship::move(ship_state, ship_position, Direction::backward, dt);
 	}
 	else {
-		ship->setAccelerationToZero();
+		ship::setAccelerationToZero(ship_state);
 	}
 
 	if (keyboard->isPressed('a')) {
-		ship->roll(Axis::z, -dt);
+		ship::roll(ship_state, Axis::z, -dt);
 	}
 
 	if (keyboard->isPressed('d')) {
-		ship->roll(Axis::z, dt);
+		ship::roll(ship_state, Axis::z, dt);
 	}
 
 	if (keyboard->isPressed(' ')) {
-		ship->shoot(dt);
+		ship::shoot(*world, ship_state, ship_position);
 	}
 
 	if (keyboard->isPressed('r')) {
 		resetGame();
 	}
 
+	// Only as the keys go down, and from here so that recorded sessions
+	// replay them at the same tick
+	if (keyboard->isPressed('z') && !quick_save_held) {
+		saveSnapshot(quick_save);
+	}
+	quick_save_held = keyboard->isPressed('z');
+	if (keyboard->isPressed('x') && !quick_load_held && !quick_save.isEmpty()) {
+		restoreSnapshot(quick_save);
+	}
+	quick_load_held = keyboard->isPressed('x');
+
 	if (keyboard->isPressed('i')) {
 		camera->look(Look::ABOVE);
 	}
@@ -355,13 +819,13 @@ void GameManager::handleKeyboardInput() {
 	else {
 		camera->look(Look::AHEAD);
 	}
-
-	if (keyboard->isAnyKeyPressed()) {
-		glutPostRedisplay();
-	}
 }
 
 void GameManager::onMouseClick(int button, int state, int x, int y) {
+	if (input_replayer) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(input_mutex);
 	switch (button) {
 	case GLUT_LEFT_BUTTON:
 		if (state == GLUT_DOWN) {
@@ -387,6 +851,10 @@ void GameManager::onMouseClick(int button, int state, int x, int y) {
 }
 
 void GameManager::onMouseMovement(int x, int y) {
+	if (input_replayer) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(input_mutex);
 	mouse->X = x;
 	mouse->Y = y;
 }
@@ -407,22 +875,211 @@ void GameManager::handleMouseInput() {
 			0, window->height,
 			camera->getAspect(), -camera->getAspect());
 
-		ship->rotate(Axis::y, dt, map_x);
-		ship->rotate(Axis::x, dt, map_y);
-
-		glutPostRedisplay();
+		Ship& ship_state = *world->get<Ship>(ship);
+		ship::rotate(ship_state, Axis::y, dt, map_x);
+		ship::rotate(ship_state, Axis::x, dt, map_y);
 	}
 }
 
+void GameManager::setThreaded(bool setting) {
+	threaded = setting;
+}
+
+void GameManager::setHeadless(bool setting) {
+	headless = setting;
+}
+
+void GameManager::setFixedTimeStep(float step) {
+	fixed_dt = step;
+}
+
+void GameManager::setShipInvulnerable(bool setting) {
+	ship_invulnerable = setting;
+}
+
+void GameManager::setFrameRate(double rate) {
+	display_pacer.setRate(rate);
+}
+
+void GameManager::setTickRate(double rate) {
+	tick_pacer.setRate(rate);
+}
+
+void GameManager::setOcclusionCulling(bool setting) {
+	occlusion_culling = setting;
+}
+
+void GameManager::setHudVisible(bool setting) {
+	hud.setVisible(setting);
+}
+
+AsteroidField& GameManager::getAsteroidField() { return *asteroid_field; }
+ecs::World& GameManager::getWorld() { return *world; }
+
+void GameManager::setInputRecorder(std::unique_ptr<InputRecorder> recorder) {
+	input_recorder = std::move(recorder);
+}
+
+void GameManager::setInputReplayer(std::unique_ptr<InputReplayer> replayer) {
+	input_replayer = std::move(replayer);
+}
+
+InputFrame GameManager::captureInput() const {
+	InputFrame frame;
+	frame.dt = dt;
+	frame.keys = keyboard->getState();
+	frame.mouse_x = mouse->X;
+	frame.mouse_y = mouse->Y;
+	frame.left_click = mouse->isHoldingLeftClick();
+	frame.right_click = mouse->isHoldingRightClick();
+	frame.window_width = static_cast<int>(window->width);
+	frame.window_height = static_cast<int>(window->height);
+	return frame;
+}
+
+void GameManager::applyInput(const InputFrame& frame) {
+	keyboard->setState(frame.keys);
+	mouse->setPosition(frame.mouse_x, frame.mouse_y);
+	mouse->setHoldingLeftClick(frame.left_click);
+	mouse->setHoldingRightClick(frame.right_click);
+	window->width = frame.window_width;
+	window->height = frame.window_height;
+	camera->setAspect(static_cast<float>(frame.window_width) / static_cast<float>(frame.window_height));
+}
+
 void GameManager::calculateTimeDelta() {
-	// gives delta time in seconds
-	const float cur_time = glutGet(GLUT_ELAPSED_TIME) / 1000.0;
-	dt = cur_time - last_time;
+	// gives delta time in seconds. Not glutGet, as this can run off the GLUT thread
+	const auto cur_time = std::chrono::steady_clock::now();
+	dt = std::chrono::duration<float>(cur_time - last_time).count();
 	last_time = cur_time;
 }
 
+// The ship goes with everything else, and starts over in the middle
 void GameManager::resetGame() {
-	ship->reset();
 	asteroid_field->reset();
-	Transparent::reset();
+	world->clear();
+	ship = ship::create(*world);
+}
+
+// Only one entity is a Ship
+void GameManager::findShip() {
+	world->each<Ship>([this](ecs::EntityId id, Ship&) {
+		ship = id;
+	});
+}
+
+void GameManager::setStateRecorder(std::unique_ptr<StateRecorder> recorder) {
+	state_recorder = std::move(recorder);
+}
+
+void GameManager::setStatePlayer(std::unique_ptr<StatePlayer> player) {
+	state_player = std::move(player);
+}
+
+void GameManager::setSnapshotServer(std::unique_ptr<SnapshotServer> server) {
+	snapshot_server = std::move(server);
+}
+
+void GameManager::setSnapshotClient(std::unique_ptr<SnapshotClient> client) {
+	snapshot_client = std::move(client);
+}
+
+void GameManager::setPlaybackSpeed(float speed) {
+	playback_speed = std::max(0.0f, speed);
+}
+
+void GameManager::captureState(WorldState& state) const {
+	state.dt = dt;
+	state.entities.clear();
+	ship::captureState(*world->get<Ship>(ship), *world->get<Position>(ship), state);
+	camera->captureState(state);
+	arena->captureState(state);
+	asteroid_field->captureState(state);
+
+	world->each<Asteroid, Position, Velocity>(
+		[&state](ecs::EntityId id, Asteroid& asteroid, Position& position, Velocity& velocity) {
+			state.entities.push_back(asteroidState(id, asteroid, position, velocity));
+		});
+	world->each<Bullet, Position, Velocity, AnimationDrawer>(
+		[&state](ecs::EntityId id, Bullet&, Position& position, Velocity& velocity, AnimationDrawer& animation) {
+			state.entities.push_back(billboardState(id, EntityKind::bullet, position, velocity, animation));
+		});
+	world->each<Explosion, Position, Velocity, AnimationDrawer>(
+		[&state](ecs::EntityId id, Explosion&, Position& position, Velocity& velocity, AnimationDrawer& animation) {
+			state.entities.push_back(billboardState(id, EntityKind::explosion, position, velocity, animation));
+		});
+}
+
+// Everything is created afresh, so has new entity ids
+void GameManager::applyState(const WorldState& state) {
+	camera->applyState(state);
+	arena->applyState(state);
+	asteroid_field->applyState(state);
+	contact_cache.clear();
+
+	world->clear();
+	ship = ship::create(*world);
+	ship::applyState(*world->get<Ship>(ship), *world->get<Position>(ship), state);
+	for (const EntityState& entity : state.entities) {
+		if (entity.kind == EntityKind::asteroid) {
+			if (entity.texture_layer >= 0 && entity.texture_layer < ASTEROID_TEXTURE_COUNT) {
+				asteroid::create(*world, entity);
+			}
+			continue;
+		}
+
+		ecs::EntityId id;
+		if (entity.kind == EntityKind::bullet) {
+			id = bullet::create(*world, entity.position, entity.velocity);
+		}
+		else if (entity.kind == EntityKind::explosion) {
+			id = explosion::spawn(*world, entity.position, entity.velocity);
+		}
+		else {
+			continue;
+		}
+		world->get<AnimationDrawer>(id)->setFrameIndex(entity.frame);
+	}
+}
+
+void GameManager::saveSnapshot(Snapshot& snapshot) const {
+	Profiler::Scope scope(Phase::snapshot);
+
+	snapshot.clear();
+	snapshot.write(SNAPSHOT_VERSION);
+	snapshot.write(utility::engine);
+	camera->save(snapshot);
+	arena->save(snapshot);
+	asteroid_field->save(snapshot);
+	world->save(snapshot);
+}
+
+// Nothing is rebuilt besides the contact bounds, which start over as they do
+// whenever a wave arrives. The ship is whichever entity it was at the save
+bool GameManager::restoreSnapshot(const Snapshot& snapshot) {
+	Profiler::Scope scope(Phase::restore);
+
+	Snapshot::Reader reader(snapshot);
+	std::uint32_t version = 0;
+	reader.read(version);
+	if (version != SNAPSHOT_VERSION) {
+		std::cerr << "Not a snapshot this build can restore, resetting instead" << std::endl;
+		resetGame();
+		return false;
+	}
+
+	reader.read(utility::engine);
+	camera->restore(reader);
+	arena->restore(reader);
+	asteroid_field->restore(reader);
+	const bool restored = world->restore(reader) && !reader.hasFailed() && reader.remaining() == 0;
+	contact_cache.clear();
+
+	if (!restored) {
+		std::cerr << "Snapshot is corrupt, resetting instead" << std::endl;
+		resetGame();
+		return false;
+	}
+	findShip();
+	return true;
 }
@@ -3,24 +3,49 @@
 
 #include "Hardware/Keyboard.h"
 #include "Hardware/Mouse.h"
+#include "Hardware/InputRecording.h"
 #include "World/Window.h"
 #include "World/Camera.h"
 #include "Asteroids/AsteroidField.h"
 #include "Asteroids/Asteroid.h"
 #include "Arena/Arena.h"
 #include "Ship/Ship.h"
-#include "Explosion/ExplosionManager.h"
+#include "ECS/World.h"
+#include "Render/RenderQueue.h"
+#include "Render/Renderer.h"
+#include "Collisions/ContactCache.h"
+#include "Collisions/ContactSolver.h"
+#include "Collisions/WallBatch.h"
+#include "Platform/FramePacer.h"
+#include "Profiling/PerformanceHud.h"
+#include "State/Snapshot.h"
+#include "State/StateStream.h"
+#include "Net/SnapshotServer.h"
+#include "Net/SnapshotClient.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 class GameManager {
 public:
 	GameManager();
+	~GameManager();
 
 	void start();
+	int run(int frame_count);
+	int serve(int tick_count, int population = 0);
 	void init();
+	void stop();
+	void finish(); // ends run() or serve() after the tick in progress, e.g. on a signal
 
-	void onDisplay();
+	// One simulation step, ending with the frame handed to the renderer
+	void tick();
+	void record(RenderFrame& frame);
+
+	bool onDisplay();
 	void onIdle();
 	void onReshape(int w, int h);
 
@@ -29,14 +54,14 @@ public:
 	void updateEntities();
 	void updateShip();
 	void updateAsteroids();
-	void updateBullets();
 	void updateSatellite();
-	void updateExplosions();
+	void updateWorld();
+	void removeMarked();
 
 	void handleCollisions();
-	void handleWallCollisions();
-	void handleAsteroidCollisions();
-	void handleBulletCollisions();
+	bool handleWallCollisions(unsigned char warning_mask, unsigned char collision_mask);
+	void handleAsteroidCollisions(ContactBodies& asteroids, const WallBatch& walls, size_t first);
+	void handleBulletCollisions(const ContactBodies& asteroids, const WallBatch& walls, size_t first);
 
 	void onKeyDown(unsigned char key, int x, int y);
 	void onKeyUp(unsigned char key, int x, int y);
@@ -47,23 +72,108 @@ public:
 	void onMouseClickDrag(int x, int y);
 	void handleMouseInput();
 
+	// Call before start()/run()
+	void setThreaded(bool setting);
+	void setHeadless(bool setting); // no GLUT window, so never swap buffers
+	void setFixedTimeStep(float step); // 0 = real time
+	void setShipInvulnerable(bool setting); // asteroids pass through rather than resetting the game
+	void setFrameRate(double rate); // display loop target, 0 = unpaced
+	void setTickRate(double rate); // simulation thread target, 0 = unpaced
+	void setOcclusionCulling(bool setting);
+	void setHudVisible(bool setting); // 'h' toggles it in game
+
+	AsteroidField& getAsteroidField();
+	ecs::World& getWorld();
+
+	// At most one of the two should be set
+	void setInputRecorder(std::unique_ptr<InputRecorder> recorder);
+	void setInputReplayer(std::unique_ptr<InputReplayer> replayer);
+	InputFrame captureInput() const;
+	void applyInput(const InputFrame& frame);
+
 	void calculateTimeDelta();
 
 	void resetGame();
 
+	// Everything the simulation needs to carry on from this moment: the world
+	// (ship, asteroids, bullets, explosions), satellite, camera, timers and the RNG.
+	// Only between ticks, so from the simulation thread or while it's stopped.
+	// restoreSnapshot returns false, leaving the game reset, if the snapshot
+	// isn't one saveSnapshot wrote
+	void saveSnapshot(Snapshot& snapshot) const;
+	bool restoreSnapshot(const Snapshot& snapshot);
+
+	// Writes every tick's state out as it's simulated. With a player set the
+	// game isn't simulated at all; each tick shows the next recorded state
+	// instead, or several of them at a playback speed over 1. '[' and ']'
+	// seek back and forward through it
+	void setStateRecorder(std::unique_ptr<StateRecorder> recorder);
+	void setStatePlayer(std::unique_ptr<StatePlayer> player);
+	void setPlaybackSpeed(float speed); // recorded ticks per tick
+	void captureState(WorldState& state) const;
+	void applyState(const WorldState& state);
+
+	// A server simulates as usual but draws nothing, sending each tick's
+	// state to its clients instead. A client doesn't simulate at all; like
+	// the state player it shows whatever the server sent last
+	void setSnapshotServer(std::unique_ptr<SnapshotServer> server);
+	void setSnapshotClient(std::unique_ptr<SnapshotClient> client);
+
 private:
+	void startSimulation();
+	bool playState();
+	void followServer();
+	void findShip();
+
 	float dt;
-	float last_time;
+	std::chrono::steady_clock::time_point last_time;
+
+	// Callbacks come in on the GLUT thread while tick() runs on the simulation
+	// one; this guards the keyboard, mouse and window they share
+	std::mutex input_mutex;
+	bool threaded;
+	bool headless;
+	float fixed_dt;
+	bool ship_invulnerable;
+	bool occlusion_culling;
+	std::atomic<bool> running;
+	std::atomic<bool> finished; // replay ran out, or finish()
+	std::thread simulation;
+	FramePacer display_pacer;
+	FramePacer tick_pacer;
+	std::unique_ptr<RenderQueue> render_queue;
+	std::unique_ptr<Renderer> renderer;
+	PerformanceHud hud;
+
+	std::unique_ptr<InputRecorder> input_recorder;
+	std::unique_ptr<InputReplayer> input_replayer;
+	InputFrame replay_input;
+
+	std::unique_ptr<StateRecorder> state_recorder;
+	std::unique_ptr<StatePlayer> state_player;
+	WorldState world_state; // reused every tick
+	float playback_speed;
+	float playback_ticks; // owed to the player at playback_speed a tick
+	std::atomic<long long> seek_ticks; // asked for from the GLUT thread
+
+	std::unique_ptr<SnapshotServer> snapshot_server;
+	std::unique_ptr<SnapshotClient> snapshot_client;
 
-	std::unique_ptr<Ship> ship;
-	
 	std::unique_ptr<Keyboard> keyboard;
 	std::unique_ptr<Mouse> mouse;
 	std::unique_ptr<Window> window;
 	std::unique_ptr<Camera> camera;
 	std::unique_ptr<Arena> arena;
 	std::unique_ptr<AsteroidField> asteroid_field;
-	std::unique_ptr<ExplosionManager> explosion_manager;
+	std::unique_ptr<ecs::World> world; // the ship, asteroids, bullets and explosions
+	ecs::EntityId ship; // made again whenever the world is cleared
+	ContactCache contact_cache;
+	ContactSolver contact_solver;
+
+	// 'z' saves, 'x' goes back to it
+	Snapshot quick_save;
+	bool quick_save_held;
+	bool quick_load_held;
 };
 
 #endif // I3D_GAMEMANAGER_H
\ No newline at end of file
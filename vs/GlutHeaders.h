@@ -4,6 +4,11 @@
 #if _WIN32
 #   include <Windows.h>
 #endif
+
+// GLEW has to come before any other GL header, and we link the static library
+#define GLEW_STATIC
+#include <GL/glew.h>
+
 #if __APPLE__
 #   include <OpenGL/gl.h>
 #   include <OpenGL/glu.h>
@@ -14,4 +19,4 @@
 #   include <GL/glut.h>
 #endif
 
-#endif // I3D_GLUTHEADERS_H
\ No newline at end of file
+#endif // I3D_GLUTHEADERS_H
@@ -0,0 +1,110 @@
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+	const char MAGIC[4] = { 'I', '3', 'D', 'R' };
+	const std::uint32_t VERSION = 1;
+
+	// bit 0 = left, bit 1 = right
+	const std::uint8_t LEFT_BUTTON = 1;
+	const std::uint8_t RIGHT_BUTTON = 2;
+
+	template <typename T>
+	void put(std::ofstream& file, T value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool get(std::ifstream& file, T& value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+}
+
+bool InputRecorder::open(const std::string& filename, std::uint32_t seed) {
+	file.open(filename, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cerr << "Failed to open " << filename << " for recording" << std::endl;
+		return false;
+	}
+
+	file.write(MAGIC, sizeof(MAGIC));
+	put(file, VERSION);
+	put(file, seed);
+	return true;
+}
+
+void InputRecorder::write(const InputFrame& frame) {
+	std::array<std::uint8_t, 32> keys{};
+	for (size_t key = 0; key < frame.keys.size(); ++key) {
+		if (frame.keys[key]) {
+			keys[key / 8] |= 1 << (key % 8);
+		}
+	}
+
+	std::uint8_t buttons = 0;
+	if (frame.left_click) {
+		buttons |= LEFT_BUTTON;
+	}
+	if (frame.right_click) {
+		buttons |= RIGHT_BUTTON;
+	}
+
+	put(file, frame.dt);
+	file.write(reinterpret_cast<const char*>(keys.data()), keys.size());
+	put(file, static_cast<std::int32_t>(frame.mouse_x));
+	put(file, static_cast<std::int32_t>(frame.mouse_y));
+	put(file, buttons);
+	put(file, static_cast<std::int16_t>(frame.window_width));
+	put(file, static_cast<std::int16_t>(frame.window_height));
+}
+
+InputReplayer::InputReplayer()
+	: seed(0) {}
+
+bool InputReplayer::open(const std::string& filename) {
+	file.open(filename, std::ios::binary);
+	if (!file) {
+		std::cerr << "Failed to open " << filename << " for replay" << std::endl;
+		return false;
+	}
+
+	char magic[4];
+	std::uint32_t version;
+	if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, MAGIC)
+		|| !get(file, version) || version != VERSION || !get(file, seed)) {
+		std::cerr << filename << " is not a recording this build can replay" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::uint32_t InputReplayer::getSeed() const {
+	return seed;
+}
+
+bool InputReplayer::read(InputFrame& frame) {
+	std::array<std::uint8_t, 32> keys;
+	std::int32_t mouse_x, mouse_y;
+	std::uint8_t buttons;
+	std::int16_t window_width, window_height;
+
+	if (!get(file, frame.dt)
+		|| !file.read(reinterpret_cast<char*>(keys.data()), keys.size())
+		|| !get(file, mouse_x) || !get(file, mouse_y) || !get(file, buttons)
+		|| !get(file, window_width) || !get(file, window_height)) {
+		return false;
+	}
+
+	for (size_t key = 0; key < frame.keys.size(); ++key) {
+		frame.keys[key] = (keys[key / 8] >> (key % 8)) & 1;
+	}
+	frame.mouse_x = mouse_x;
+	frame.mouse_y = mouse_y;
+	frame.left_click = buttons & LEFT_BUTTON;
+	frame.right_click = buttons & RIGHT_BUTTON;
+	frame.window_width = window_width;
+	frame.window_height = window_height;
+	return true;
+}
@@ -0,0 +1,50 @@
+#ifndef I3D_INPUTRECORDING_H
+#define I3D_INPUTRECORDING_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Everything the simulation reads from the outside world in one tick. The
+// window size is in here because mouse steering is mapped relative to it
+struct InputFrame {
+	float dt;
+	std::array<bool, 256> keys;
+	int mouse_x;
+	int mouse_y;
+	bool left_click;
+	bool right_click;
+	int window_width;
+	int window_height;
+};
+
+// Binary session file: a header with the RNG seed, then one record per tick.
+// Keys are packed into a 32 byte bitset, so each tick costs 49 bytes.
+// Written in native byte order, as recordings are replayed on the same hosts
+
+class InputRecorder {
+public:
+	bool open(const std::string& filename, std::uint32_t seed);
+	void write(const InputFrame& frame);
+
+private:
+	std::ofstream file;
+};
+
+class InputReplayer {
+public:
+	InputReplayer();
+
+	bool open(const std::string& filename);
+	std::uint32_t getSeed() const;
+
+	// false once the recording runs out
+	bool read(InputFrame& frame);
+
+private:
+	std::ifstream file;
+	std::uint32_t seed;
+};
+
+#endif // I3D_INPUTRECORDING_H
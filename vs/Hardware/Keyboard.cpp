@@ -27,4 +27,12 @@ bool Keyboard::isAnyKeyPressed() {
 		}
 	}
 	return false;
+}
+
+const std::array<bool, 256>& Keyboard::getState() const {
+	return state_of;
+}
+
+void Keyboard::setState(const std::array<bool, 256>& state) {
+	state_of = state;
 }
\ No newline at end of file
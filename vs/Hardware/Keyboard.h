@@ -9,6 +9,9 @@ public:
 	void setPressed(unsigned char key, bool state);
 	bool isPressed(unsigned char key);
 	bool isAnyKeyPressed();
+
+	const std::array<bool, 256>& getState() const;
+	void setState(const std::array<bool, 256>& state);
 private:
 	std::array<bool, 256> state_of;
 };
@@ -0,0 +1,66 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "Matrix.h"
+#include "Utility.h"
+
+matrix::Matrix matrix::identity() {
+	return {
+		1, 0, 0, 0,
+		0, 1, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1
+	};
+}
+
+matrix::Matrix matrix::translation(const Vector3D& v) {
+	return {
+		1,		0,		0,		0,
+		0,		1,		0,		0,
+		0,		0,		1,		0,
+		v.X,	v.Y,	v.Z,	1
+	};
+}
+
+matrix::Matrix matrix::scale(float x, float y, float z) {
+	return {
+		x, 0, 0, 0,
+		0, y, 0, 0,
+		0, 0, z, 0,
+		0, 0, 0, 1
+	};
+}
+
+// See the glRotate man page for the derivation
+matrix::Matrix matrix::rotation(float angle, const Vector3D& axis) {
+	Vector3D n = Vector3D::normalise(axis);
+	float radians = utility::toRadians(angle);
+	float c = cosf(radians);
+	float s = sinf(radians);
+	float t = 1 - c;
+
+	return {
+		n.X * n.X * t + c,			n.Y * n.X * t + n.Z * s,	n.X * n.Z * t - n.Y * s,	0,
+		n.X * n.Y * t - n.Z * s,	n.Y * n.Y * t + c,			n.Y * n.Z * t + n.X * s,	0,
+		n.X * n.Z * t + n.Y * s,	n.Y * n.Z * t - n.X * s,	n.Z * n.Z * t + c,			0,
+		0,							0,							0,							1
+	};
+}
+
+matrix::Matrix matrix::fromQuaternion(const Quaternion& q) {
+	return Quaternion::toMatrix(q);
+}
+
+matrix::Matrix matrix::multiply(const Matrix& lhs, const Matrix& rhs) {
+	Matrix result;
+	for (int col = 0; col < 4; ++col) {
+		for (int row = 0; row < 4; ++row) {
+			float sum = 0;
+			for (int k = 0; k < 4; ++k) {
+				sum += lhs[k * 4 + row] * rhs[col * 4 + k];
+			}
+			result[col * 4 + row] = sum;
+		}
+	}
+	return result;
+}
@@ -0,0 +1,23 @@
+#ifndef I3D_MATRIX_H
+#define I3D_MATRIX_H
+
+#include "Vector3D.h"
+#include "Quaternion.h"
+
+#include <array>
+
+// Column-major 4x4 matrices laid out the way glMultMatrixf/glLoadMatrixf expect,
+// so transforms can be built off the GL thread and handed to it as plain data
+namespace matrix {
+	using Matrix = std::array<float, 16>;
+
+	Matrix identity();
+	Matrix translation(const Vector3D& v);
+	Matrix scale(float x, float y, float z);
+	Matrix rotation(float angle, const Vector3D& axis); // same arguments as glRotatef
+	Matrix fromQuaternion(const Quaternion& q);
+
+	Matrix multiply(const Matrix& lhs, const Matrix& rhs); // lhs * rhs, as successive glMultMatrixf calls
+}
+
+#endif // I3D_MATRIX_H
@@ -2,21 +2,37 @@
 #include "GlutHeaders.h"
 
 int utility::randSign() {
-	const std::discrete_distribution<int> int_dist{ 1,2 };
-	return int_dist(engine) % 2 == 0 ? 1 : -1;
+	return randSign(engine);
 }
 
 // a must be less than b
 float utility::randFloat(float a, float b) {
+	return randFloat(engine, a, b);
+}
+
+int utility::randInt(int a, int b) {
+	return randInt(engine, a, b);
+}
+
+int utility::randSign(std::mt19937& rng) {
+	std::discrete_distribution<int> int_dist{ 1,2 };
+	return int_dist(rng) % 2 == 0 ? 1 : -1;
+}
+
+float utility::randFloat(std::mt19937& rng, float a, float b) {
 	std::uniform_real_distribution<float> real_dist =
 		std::uniform_real_distribution<float>{ a, b };
-	return real_dist(engine);
+	return real_dist(rng);
 }
 
-int utility::randInt(int a, int b) {
+int utility::randInt(std::mt19937& rng, int a, int b) {
 	std::uniform_int_distribution<int> real_dist =
 		std::uniform_int_distribution<int>{ a, b };
-	return real_dist(engine);
+	return real_dist(rng);
+}
+
+void utility::seed(unsigned int value) {
+	engine.seed(value);
 }
 
 float utility::toRadians(float angle) {
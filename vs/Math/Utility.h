@@ -8,18 +8,27 @@
 #include <random>
 
 namespace utility {
-	const float pi = std::acosf(-1.0);
+	const float pi = std::acos(-1.0f);
 
 	int randSign();
 	float randFloat(float a, float b);
 	int randInt(int a, int b);
+
+	// The same, drawing from a given engine instead, e.g. one a worker thread
+	// seeded from the shared one so the results are still reproducible
+	int randSign(std::mt19937& rng);
+	float randFloat(std::mt19937& rng, float a, float b);
+	int randInt(std::mt19937& rng, int a, int b);
 	
 	float toRadians(float angle);
 	float toDegrees(float angle);
 
 	float mapToRange(float value, float old_min, float old_max, float new_min, float new_max);
 
-	static std::random_device engine;
+	// Every bit of gameplay randomness comes from this one engine, so a
+	// session can be reproduced by seeding it the same way
+	void seed(unsigned int value);
+	inline std::mt19937 engine;
 }
 
 #endif
\ No newline at end of file
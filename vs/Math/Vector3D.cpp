@@ -53,8 +53,12 @@ float Vector3D::magnitude(Vector3D v) {
 }
 
 Vector3D Vector3D::randomUnit() {
-	float theta = utility::randFloat(0, 360);
-	float phi = utility::randFloat(-180, 180);
+	return randomUnit(utility::engine);
+}
+
+Vector3D Vector3D::randomUnit(std::mt19937& rng) {
+	float theta = utility::randFloat(rng, 0, 360);
+	float phi = utility::randFloat(rng, -180, 180);
 	return fromAngles(theta, phi, 1);
 }
 
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <array>
+#include <random>
 
 class Vector3D {
 public:
@@ -29,6 +30,7 @@ public:
 	static float magnitude(Vector3D v);
 
 	static Vector3D randomUnit();
+	static Vector3D randomUnit(std::mt19937& rng);
 
 	static Vector3D red();
 	static Vector3D green();
@@ -0,0 +1,53 @@
+#ifndef I3D_FRAMEALLOCATOR_H
+#define I3D_FRAMEALLOCATOR_H
+
+#include "FrameArena.h"
+
+#include <cstddef>
+#include <vector>
+
+// Standard allocator that takes its memory from a FrameArena, this thread's
+// unless told otherwise. deallocate is a no-op, so a container growing
+// leaves its old storage behind until the reset; reserve up front.
+template <typename T>
+class FrameAllocator {
+public:
+	using value_type = T;
+
+	FrameAllocator()
+		: arena(&FrameArena::local()) {}
+
+	explicit FrameAllocator(FrameArena& arena)
+		: arena(&arena) {}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other)
+		: arena(other.arena) {}
+
+	T* allocate(std::size_t n) {
+		return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, std::size_t) {}
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U>& other) const {
+		return arena == other.arena;
+	}
+
+	template <typename U>
+	bool operator!=(const FrameAllocator<U>& other) const {
+		return arena != other.arena;
+	}
+
+private:
+	template <typename U>
+	friend class FrameAllocator;
+
+	FrameArena* arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+#endif // I3D_FRAMEALLOCATOR_H
@@ -0,0 +1,97 @@
+#include "FrameArena.h"
+#include "Constants/MemoryConstants.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <new>
+
+FrameArena::FrameArena(std::size_t capacity)
+	: block(new unsigned char[capacity])
+	, capacity(capacity)
+	, offset(0)
+	, overflow_bytes(0)
+	, stats(std::make_shared<Stats>())
+{
+	stats->capacity = capacity;
+	stats->high_water = 0;
+	stats->overflowed_frames = 0;
+
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	stats->id = static_cast<int>(registry.size());
+	registry.push_back(stats);
+}
+
+FrameArena::~FrameArena() {
+	reset();
+}
+
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+	void* pointer = block.get() + offset;
+	std::size_t space = capacity - offset;
+	if (std::align(alignment, bytes, pointer, space)) {
+		offset = capacity - space + bytes;
+		return pointer;
+	}
+
+	// Out of room this frame; operator new is aligned enough for anything
+	// we'd be asked for
+	pointer = ::operator new(bytes);
+	overflow.push_back(pointer);
+	overflow_bytes += bytes;
+	return pointer;
+}
+
+void FrameArena::reset() {
+	const std::size_t used = getUsed();
+	if (used > stats->high_water) {
+		stats->high_water = used;
+	}
+
+	if (!overflow.empty()) {
+		for (void* pointer : overflow) {
+			::operator delete(pointer);
+		}
+		overflow.clear();
+		++stats->overflowed_frames;
+
+		// Make room for a frame like this one. The arena is empty here, so
+		// nothing's lost by replacing the block
+		do {
+			capacity *= 2;
+		} while (capacity < used);
+		block.reset(new unsigned char[capacity]);
+		stats->capacity = capacity;
+	}
+
+	offset = 0;
+	overflow_bytes = 0;
+}
+
+std::size_t FrameArena::getUsed() const {
+	return offset + overflow_bytes;
+}
+
+std::size_t FrameArena::getCapacity() const {
+	return capacity;
+}
+
+std::size_t FrameArena::getHighWater() const {
+	return stats->high_water;
+}
+
+FrameArena& FrameArena::local() {
+	thread_local FrameArena arena(FRAME_ARENA_CAPACITY);
+	return arena;
+}
+
+void FrameArena::report(std::ostream& out) {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (const std::shared_ptr<Stats>& arena : registry) {
+		out << "Frame arena " << arena->id << ": high water " << std::fixed << std::setprecision(1)
+			<< arena->high_water / 1024.0 << " KiB of " << arena->capacity / 1024.0 << " KiB";
+		if (arena->overflowed_frames > 0) {
+			out << ", overflowed in " << arena->overflowed_frames << " frames";
+		}
+		out << std::endl;
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef I3D_FRAMEARENA_H
+#define I3D_FRAMEARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Scratch memory that only has to last until the end of the current tick.
+// Allocating bumps an offset through one block and freeing does nothing;
+// reset() hands the whole block back at once. Every thread gets its own
+// arena from local(), so there's nothing to lock, and whoever drives that
+// thread's frames resets it (GameManager::tick and onDisplay).
+//
+// Nothing allocated from an arena may outlive the reset, so keep it to
+// locals. Use FrameAllocator to put containers in one.
+class FrameArena {
+public:
+	explicit FrameArena(std::size_t capacity);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// alignment must be a power of two no larger than alignof(std::max_align_t)
+	void* allocate(std::size_t bytes, std::size_t alignment);
+	void reset();
+
+	std::size_t getUsed() const;
+	std::size_t getCapacity() const;
+	std::size_t getHighWater() const; // most used in any one frame so far
+
+	static FrameArena& local();
+
+	// High-water marks of every thread's arena, including finished threads
+	static void report(std::ostream& out);
+
+private:
+	// Kept apart from the arena so report() can still read it once the
+	// thread, and its arena, are gone
+	struct Stats {
+		int id;
+		std::atomic<std::size_t> capacity;
+		std::atomic<std::size_t> high_water;
+		std::atomic<int> overflowed_frames;
+	};
+
+	std::unique_ptr<unsigned char[]> block;
+	std::size_t capacity;
+	std::size_t offset;
+
+	// Allocations that didn't fit, freed at the next reset
+	std::vector<void*> overflow;
+	std::size_t overflow_bytes;
+
+	std::shared_ptr<Stats> stats;
+
+	inline static std::mutex registry_mutex;
+	inline static std::vector<std::shared_ptr<Stats>> registry;
+};
+
+#endif // I3D_FRAMEARENA_H
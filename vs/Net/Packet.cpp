@@ -0,0 +1,56 @@
+#include "Packet.h"
+
+#include <cstring>
+
+namespace {
+	std::uint32_t constexpr MAGIC = 0x4e443349; // "I3DN"
+
+	template <typename T>
+	void put(std::vector<unsigned char>& out, T value) {
+		const size_t at = out.size();
+		out.resize(at + sizeof(value));
+		std::memcpy(out.data() + at, &value, sizeof(value));
+	}
+
+	template <typename T>
+	T read(const unsigned char* at) {
+		T value;
+		std::memcpy(&value, at, sizeof(value));
+		return value;
+	}
+}
+
+void packet::begin(std::vector<unsigned char>& out, Type type) {
+	out.clear();
+	put(out, MAGIC);
+	put(out, static_cast<std::uint8_t>(type));
+}
+
+void packet::putU16(std::vector<unsigned char>& out, std::uint16_t value) {
+	put(out, value);
+}
+
+void packet::putU32(std::vector<unsigned char>& out, std::uint32_t value) {
+	put(out, value);
+}
+
+bool packet::readType(const unsigned char* data, size_t size, Type& type) {
+	if (size < HEADER_SIZE || read<std::uint32_t>(data) != MAGIC) {
+		return false;
+	}
+
+	const std::uint8_t value = data[sizeof(MAGIC)];
+	if (value < static_cast<std::uint8_t>(Type::hello) || value > static_cast<std::uint8_t>(Type::snapshot)) {
+		return false;
+	}
+	type = static_cast<Type>(value);
+	return true;
+}
+
+std::uint16_t packet::readU16(const unsigned char* at) {
+	return read<std::uint16_t>(at);
+}
+
+std::uint32_t packet::readU32(const unsigned char* at) {
+	return read<std::uint32_t>(at);
+}
@@ -0,0 +1,42 @@
+#ifndef I3D_PACKET_H
+#define I3D_PACKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// What the server and its clients send each other. Every datagram starts
+// with the protocol's magic number and its type:
+//	hello		client to server, asking for snapshots
+//	ack			client to server, the newest tick it has decoded
+//	bye			client to server, leaving
+//	snapshot	server to client, the tick, the tick it's a delta against
+//				(NO_BASELINE for a keyframe), which fragment of how many this
+//				is, then that fragment of the encoded state
+// Fixed fields are native byte order, like the recordings, which is fine
+// between machines of the same kind and always over loopback.
+namespace packet {
+	enum class Type : std::uint8_t {
+		hello = 1,
+		ack,
+		bye,
+		snapshot
+	};
+
+	std::uint32_t constexpr NO_BASELINE = 0xffffffff;
+	size_t constexpr HEADER_SIZE = 5;
+	size_t constexpr ACK_SIZE = HEADER_SIZE + 4;
+	size_t constexpr SNAPSHOT_HEADER_SIZE = HEADER_SIZE + 12;
+
+	// Clear out and start a packet of type in it
+	void begin(std::vector<unsigned char>& out, Type type);
+	void putU16(std::vector<unsigned char>& out, std::uint16_t value);
+	void putU32(std::vector<unsigned char>& out, std::uint32_t value);
+
+	// false if data isn't one of ours
+	bool readType(const unsigned char* data, size_t size, Type& type);
+	std::uint16_t readU16(const unsigned char* at);
+	std::uint32_t readU32(const unsigned char* at);
+}
+
+#endif // I3D_PACKET_H
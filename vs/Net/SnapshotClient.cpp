@@ -0,0 +1,166 @@
+#include "SnapshotClient.h"
+#include "Packet.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+	double seconds(SnapshotClient::Clock::duration duration) {
+		return std::chrono::duration<double>(duration).count();
+	}
+}
+
+SnapshotClient::SnapshotClient()
+	: server()
+	, connected(false)
+	, history()
+	, has_state(false)
+	, newest(0)
+	, empty()
+	, assembling(packet::NO_BASELINE)
+	, assembling_baseline(packet::NO_BASELINE)
+	, assembly_size(0)
+	, fragments_missing(0)
+	, incoming(NET_MAX_PACKET)
+	, lost(false)
+	, bytes_received(0)
+	, snapshots(0)
+	, keyframes(0)
+	, stale(0)
+	, incomplete(0)
+	, undecodable(0) {
+	history_ticks.fill(packet::NO_BASELINE);
+}
+
+SnapshotClient::~SnapshotClient() {
+	if (connected) {
+		packet::begin(outgoing, packet::Type::bye);
+		socket.send(server, outgoing.data(), outgoing.size());
+	}
+}
+
+bool SnapshotClient::connect(const NetAddress& server) {
+	if (!socket.open(0)) {
+		return false;
+	}
+	this->server = server;
+	connected = true;
+	std::cout << "Waiting for snapshots from " << server.toString() << std::endl;
+	sayHello(Clock::now());
+	return true;
+}
+
+bool SnapshotClient::poll(WorldState& state) {
+	const Clock::time_point now = Clock::now();
+	bool decoded = false;
+
+	NetAddress from;
+	long size;
+	while ((size = socket.receive(from, incoming.data(), incoming.size())) >= 0) {
+		packet::Type type;
+		if (!(from == server) || !packet::readType(incoming.data(), static_cast<size_t>(size), type)
+			|| type != packet::Type::snapshot || static_cast<size_t>(size) < packet::SNAPSHOT_HEADER_SIZE) {
+			continue;
+		}
+		if (bytes_received == 0) {
+			first_heard = now;
+		}
+		bytes_received += static_cast<std::uint64_t>(size);
+		last_heard = now;
+		lost = false;
+
+		const unsigned char* header = incoming.data() + packet::HEADER_SIZE;
+		const std::uint32_t tick = packet::readU32(header);
+		const std::uint32_t baseline = packet::readU32(header + 4);
+		const std::uint16_t fragment = packet::readU16(header + 8);
+		const std::uint16_t count = packet::readU16(header + 10);
+		const size_t length = size - packet::SNAPSHOT_HEADER_SIZE;
+		if (fragment >= count || (fragment + 1 < count && length != NET_FRAGMENT_SIZE)) {
+			continue;
+		}
+		if ((has_state && tick <= newest) || (assembling != packet::NO_BASELINE && tick < assembling)) {
+			++stale;
+			continue;
+		}
+
+		if (tick != assembling) {
+			incomplete += assembling != packet::NO_BASELINE ? 1 : 0;
+			assembling = tick;
+			assembling_baseline = baseline;
+			assembly.resize(count * NET_FRAGMENT_SIZE);
+			fragments.assign(count, false);
+			fragments_missing = count;
+		}
+		if (fragments.size() != count || baseline != assembling_baseline || fragments[fragment]) {
+			continue;
+		}
+		const unsigned char* body = incoming.data() + packet::SNAPSHOT_HEADER_SIZE;
+		std::copy(body, body + length, assembly.begin() + fragment * NET_FRAGMENT_SIZE);
+		if (fragment + 1 == count) {
+			assembly_size = fragment * NET_FRAGMENT_SIZE + length;
+		}
+		fragments[fragment] = true;
+		if (--fragments_missing > 0) {
+			continue;
+		}
+		assembling = packet::NO_BASELINE;
+
+		const bool keyframe = baseline == packet::NO_BASELINE;
+		if (!keyframe && history_ticks[baseline % NET_HISTORY] != baseline) {
+			++undecodable;
+			continue;
+		}
+
+		statestream::State& target = history[tick % NET_HISTORY];
+		history_ticks[tick % NET_HISTORY] = packet::NO_BASELINE;
+		if (!statestream::decode(assembly.data(), assembly_size,
+			keyframe ? empty : history[baseline % NET_HISTORY], target, scratch)) {
+			++undecodable;
+			continue;
+		}
+		history_ticks[tick % NET_HISTORY] = tick;
+		has_state = true;
+		newest = tick;
+		decoded = true;
+		++snapshots;
+		keyframes += keyframe ? 1 : 0;
+	}
+
+	if (decoded) {
+		statestream::dequantise(history[newest % NET_HISTORY], state);
+		sendAck(newest);
+		return true;
+	}
+
+	// A server that's been restarted counts from 0 again, so forget the old one's ticks
+	if (has_state && !lost && seconds(now - last_heard) > NET_CLIENT_TIMEOUT) {
+		std::cout << "Lost " << server.toString() << ", waiting for it to come back" << std::endl;
+		lost = true;
+		has_state = false;
+		history_ticks.fill(packet::NO_BASELINE);
+		assembling = packet::NO_BASELINE;
+	}
+	if (!has_state && seconds(now - last_hello) > NET_HELLO_INTERVAL) {
+		sayHello(now);
+	}
+	return false;
+}
+
+void SnapshotClient::sendAck(std::uint32_t tick) {
+	packet::begin(outgoing, packet::Type::ack);
+	packet::putU32(outgoing, tick);
+	socket.send(server, outgoing.data(), outgoing.size());
+}
+
+void SnapshotClient::sayHello(Clock::time_point now) {
+	packet::begin(outgoing, packet::Type::hello);
+	socket.send(server, outgoing.data(), outgoing.size());
+	last_hello = now;
+}
+
+void SnapshotClient::report(std::ostream& out) const {
+	const double listening = std::max(seconds(last_heard - first_heard), 1e-3);
+	out << "Client: " << snapshots << " snapshots from " << server.toString() << ", " << keyframes << " keyframes, "
+		<< bytes_received / 1024.0 << " KiB, " << bytes_received / 1024.0 / listening << " KiB/s; "
+		<< stale << " stale, " << incomplete << " incomplete, " << undecodable << " undecodable" << std::endl;
+}
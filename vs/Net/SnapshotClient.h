@@ -0,0 +1,73 @@
+#ifndef I3D_SNAPSHOTCLIENT_H
+#define I3D_SNAPSHOTCLIENT_H
+
+#include "Platform/UdpSocket.h"
+#include "State/StateCodec.h"
+#include "Constants/NetConstants.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// The other end of a SnapshotServer. Says hello until snapshots start
+// arriving, then acknowledges each one it decodes so the server knows what
+// to delta the next against. Decoded ticks are kept for NET_HISTORY ticks,
+// the same as the server keeps them, so any baseline it picks is still here
+// unless a fragment of it was lost. Fragments of one snapshot are gathered
+// until they're all in; one of a newer snapshot arriving first abandons it.
+class SnapshotClient {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	SnapshotClient();
+	~SnapshotClient(); // says bye
+
+	bool connect(const NetAddress& server);
+
+	// Reads everything that's arrived since the last call. Returns true with
+	// the newest snapshot in state if there was one newer than last time
+	bool poll(WorldState& state);
+
+	void report(std::ostream& out) const;
+
+private:
+	void sendAck(std::uint32_t tick);
+	void sayHello(Clock::time_point now);
+
+	UdpSocket socket;
+	NetAddress server;
+	bool connected;
+
+	std::array<statestream::State, NET_HISTORY> history; // by tick % NET_HISTORY
+	std::array<std::uint32_t, NET_HISTORY> history_ticks; // which tick's in each, or NO_BASELINE
+	bool has_state;
+	std::uint32_t newest;
+	statestream::State empty;
+	statestream::Scratch scratch;
+
+	// the snapshot whose fragments are arriving
+	std::uint32_t assembling; // its tick, or NO_BASELINE if none are
+	std::uint32_t assembling_baseline;
+	std::vector<unsigned char> assembly;
+	size_t assembly_size;
+	std::vector<bool> fragments;
+	size_t fragments_missing;
+
+	std::vector<unsigned char> incoming;
+	std::vector<unsigned char> outgoing;
+	Clock::time_point last_hello;
+	Clock::time_point first_heard;
+	Clock::time_point last_heard;
+	bool lost; // the server's gone quiet, so it's back to saying hello
+
+	std::uint64_t bytes_received;
+	std::uint64_t snapshots;
+	std::uint64_t keyframes;
+	std::uint64_t stale; // arrived after a newer one
+	std::uint64_t incomplete; // some fragment never arrived
+	std::uint64_t undecodable; // their baseline never arrived
+};
+
+#endif // I3D_SNAPSHOTCLIENT_H
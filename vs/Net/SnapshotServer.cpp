@@ -0,0 +1,183 @@
+#include "SnapshotServer.h"
+#include "Packet.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+	double kiB(std::uint64_t bytes) {
+		return bytes / 1024.0;
+	}
+
+	double seconds(SnapshotServer::Clock::duration duration) {
+		return std::chrono::duration<double>(duration).count();
+	}
+}
+
+void SnapshotServer::Timings::add(double ms) {
+	total_ms += ms;
+	max_ms = std::max(max_ms, ms);
+	++count;
+}
+
+SnapshotServer::SnapshotServer()
+	: tick(0)
+	, history()
+	, empty()
+	, encoded_tick(packet::NO_BASELINE)
+	, encoded_baseline(packet::NO_BASELINE)
+	, incoming(NET_MAX_PACKET)
+	, oversized(0)
+	, simulation()
+	, snapshot() {}
+
+bool SnapshotServer::open(std::uint16_t port) {
+	if (!socket.open(port)) {
+		return false;
+	}
+	std::cout << "Serving snapshots on port " << port << std::endl;
+	return true;
+}
+
+void SnapshotServer::update(const WorldState& state, float tick_ms) {
+	const Clock::time_point start = Clock::now();
+	simulation.add(tick_ms);
+
+	receive();
+
+	statestream::quantise(state, history[tick % NET_HISTORY]);
+	for (Client& client : clients) {
+		send(client);
+	}
+	++tick;
+
+	snapshot.add(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+}
+
+size_t SnapshotServer::getClientCount() const {
+	return clients.size();
+}
+
+void SnapshotServer::receive() {
+	const Clock::time_point now = Clock::now();
+
+	NetAddress from;
+	long size;
+	while ((size = socket.receive(from, incoming.data(), incoming.size())) >= 0) {
+		packet::Type type;
+		if (!packet::readType(incoming.data(), static_cast<size_t>(size), type)) {
+			continue;
+		}
+
+		auto known = std::find_if(clients.begin(), clients.end(),
+			[&from](const Client& client) { return client.address == from; });
+		if (type == packet::Type::bye) {
+			if (known != clients.end()) {
+				leave(known - clients.begin());
+			}
+			continue;
+		}
+
+		// An ack from someone unknown is a client that timed out and came back
+		Client* client = known != clients.end() ? &*known : nullptr;
+		if (client == nullptr) {
+			if (clients.size() >= NET_MAX_CLIENTS) {
+				continue;
+			}
+			client = &join(from);
+		}
+		client->last_heard = now;
+
+		if (type == packet::Type::ack && static_cast<size_t>(size) >= packet::ACK_SIZE) {
+			const std::uint32_t acked = packet::readU32(incoming.data() + packet::HEADER_SIZE);
+			// out of order acks, and any for ticks not sent yet, are ignored
+			if (acked < tick && (client->acked == packet::NO_BASELINE || acked > client->acked)) {
+				client->acked = acked;
+			}
+		}
+	}
+
+	for (size_t i = clients.size(); i-- > 0;) {
+		if (seconds(now - clients[i].last_heard) > NET_CLIENT_TIMEOUT) {
+			std::cout << clients[i].address.toString() << " timed out" << std::endl;
+			leave(i);
+		}
+	}
+}
+
+SnapshotServer::Client& SnapshotServer::join(const NetAddress& address) {
+	const Clock::time_point now = Clock::now();
+	clients.push_back({ address, packet::NO_BASELINE, now, now, 0, 0, 0 });
+	std::cout << address.toString() << " joined" << std::endl;
+	return clients.back();
+}
+
+void SnapshotServer::leave(size_t index) {
+	departed.push_back(clients[index]);
+	clients.erase(clients.begin() + index);
+}
+
+void SnapshotServer::send(Client& client) {
+	const bool keyframe = client.acked == packet::NO_BASELINE || tick - client.acked >= NET_HISTORY;
+	const std::uint32_t baseline = keyframe ? packet::NO_BASELINE : client.acked;
+
+	if (encoded_tick != tick || encoded_baseline != baseline) {
+		encoded.clear();
+		statestream::encode(keyframe ? empty : history[baseline % NET_HISTORY], history[tick % NET_HISTORY], encoded);
+		encoded_tick = tick;
+		encoded_baseline = baseline;
+	}
+
+	const size_t fragments = std::max<size_t>(1, (encoded.size() + NET_FRAGMENT_SIZE - 1) / NET_FRAGMENT_SIZE);
+	if (fragments > NET_MAX_FRAGMENTS) {
+		if (oversized++ == 0) {
+			std::cerr << "A " << kiB(encoded.size()) << " KiB snapshot is too big to send" << std::endl;
+		}
+		return;
+	}
+
+	for (size_t fragment = 0; fragment < fragments; ++fragment) {
+		const size_t start = fragment * NET_FRAGMENT_SIZE;
+		const size_t end = std::min(start + NET_FRAGMENT_SIZE, encoded.size());
+		packet::begin(datagram, packet::Type::snapshot);
+		packet::putU32(datagram, tick);
+		packet::putU32(datagram, baseline);
+		packet::putU16(datagram, static_cast<std::uint16_t>(fragment));
+		packet::putU16(datagram, static_cast<std::uint16_t>(fragments));
+		datagram.insert(datagram.end(), encoded.begin() + start, encoded.begin() + end);
+
+		if (socket.send(client.address, datagram.data(), datagram.size())) {
+			client.bytes_sent += datagram.size();
+		}
+	}
+	++client.snapshots;
+	client.keyframes += keyframe ? 1 : 0;
+}
+
+void SnapshotServer::report(std::ostream& out) const {
+	auto mean = [](const Timings& timings) {
+		return timings.count > 0 ? timings.total_ms / timings.count : 0;
+	};
+
+	out << "Server: " << tick << " ticks, simulating " << mean(simulation) << " ms mean, "
+		<< simulation.max_ms << " ms max; snapshots " << mean(snapshot) << " ms mean, "
+		<< snapshot.max_ms << " ms max";
+	if (oversized > 0) {
+		out << "; " << oversized << " too big to send";
+	}
+	out << std::endl;
+
+	auto reportClient = [&out](const Client& client, const char* status) {
+		const double connected = std::max(seconds(client.last_heard - client.joined), 1e-3);
+		out << "  " << client.address.toString() << " (" << status << "): " << client.snapshots << " snapshots, "
+			<< client.keyframes << " keyframes, " << kiB(client.bytes_sent) << " KiB, "
+			<< (client.snapshots > 0 ? client.bytes_sent / static_cast<double>(client.snapshots) : 0) << " bytes/snapshot, "
+			<< kiB(client.bytes_sent) / connected << " KiB/s" << std::endl;
+	};
+	for (const Client& client : clients) {
+		reportClient(client, "connected");
+	}
+	for (const Client& client : departed) {
+		reportClient(client, "left");
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef I3D_SNAPSHOTSERVER_H
+#define I3D_SNAPSHOTSERVER_H
+
+#include "Platform/UdpSocket.h"
+#include "State/StateCodec.h"
+#include "Constants/NetConstants.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Sends every client that's said hello a snapshot of the world each tick.
+// Each snapshot is a delta against the newest tick that client has
+// acknowledged, so a lost datagram only makes the next delta a bit bigger.
+// A client that hasn't acknowledged anything yet, or whose last ack is
+// older than the NET_HISTORY ticks kept here, gets a keyframe instead.
+// Clients that go quiet for NET_CLIENT_TIMEOUT are dropped. Snapshots go out
+// in NET_FRAGMENT_SIZE pieces, and a client only decodes one once it has
+// every piece, so losing any of them costs the whole tick.
+class SnapshotServer {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	SnapshotServer();
+
+	bool open(std::uint16_t port);
+
+	// Once a tick, with the state just simulated and how long that took
+	void update(const WorldState& state, float tick_ms);
+
+	size_t getClientCount() const;
+
+	// Tick and snapshot cost, then bandwidth for every client there's been
+	void report(std::ostream& out) const;
+
+private:
+	struct Client {
+		NetAddress address;
+		std::uint32_t acked; // packet::NO_BASELINE until the first ack
+		Clock::time_point joined;
+		Clock::time_point last_heard;
+		std::uint64_t bytes_sent;
+		std::uint64_t snapshots;
+		std::uint64_t keyframes;
+	};
+
+	struct Timings {
+		double total_ms;
+		double max_ms;
+		std::uint64_t count;
+
+		void add(double ms);
+	};
+
+	void receive();
+	Client& join(const NetAddress& address);
+	void leave(size_t index);
+	void send(Client& client);
+
+	UdpSocket socket;
+	std::uint32_t tick;
+	std::array<statestream::State, NET_HISTORY> history; // by tick % NET_HISTORY
+	statestream::State empty;
+	std::vector<Client> clients;
+	std::vector<Client> departed; // only for the report
+
+	// The last snapshot encoded, reused for every client on the same baseline
+	std::vector<unsigned char> encoded;
+	std::uint32_t encoded_tick;
+	std::uint32_t encoded_baseline;
+	std::vector<unsigned char> datagram;
+	std::vector<unsigned char> incoming;
+
+	std::uint64_t oversized;
+	Timings simulation;
+	Timings snapshot;
+};
+
+#endif // I3D_SNAPSHOTSERVER_H
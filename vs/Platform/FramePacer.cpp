@@ -0,0 +1,126 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#if _WIN32
+#   include <Windows.h>
+#   include <timeapi.h>
+#   pragma comment(lib, "winmm.lib")
+#endif
+
+namespace {
+	double toMs(FramePacer::Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+FramePacer::FramePacer(double rate)
+	: period(0)
+	, started(false)
+	, sleep_overshoot(std::chrono::microseconds(PACER_SPIN_MARGIN))
+	, intervals()
+	, interval_count(0) {
+	setRate(rate);
+
+#if _WIN32
+	// The default scheduler tick is ~15.6 ms, far coarser than a frame
+	timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer() {
+#if _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::setRate(double rate) {
+	period = rate > 0
+		? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate))
+		: Clock::duration::zero();
+	started = false;
+}
+
+double FramePacer::getRate() const {
+	return period.count() > 0 ? 1.0 / std::chrono::duration<double>(period).count() : 0;
+}
+
+void FramePacer::wait() {
+	if (period.count() == 0) {
+		return;
+	}
+
+	Clock::time_point now = Clock::now();
+	if (!started) {
+		started = true;
+		deadline = now + period;
+		last = now;
+		return;
+	}
+
+	if (now > deadline + period) {
+		deadline = now;
+	}
+	else {
+		sleepUntil(deadline);
+		now = Clock::now();
+	}
+
+	intervals[interval_count % intervals.size()] = static_cast<float>(toMs(now - last));
+	++interval_count;
+	last = now;
+	deadline += period;
+}
+
+// Sleeps a slice at a time while there's clearly room for another one, then
+// yields until the deadline. Every slice's overshoot feeds the estimate of
+// how close to the deadline it's still safe to sleep; it decays so that one
+// late wake-up doesn't leave the loop spinning for good
+void FramePacer::sleepUntil(Clock::time_point deadline) {
+	const Clock::duration slice = std::chrono::microseconds(PACER_SLEEP_SLICE);
+
+	Clock::time_point now = Clock::now();
+	while (deadline - now > slice + sleep_overshoot) {
+		std::this_thread::sleep_for(slice);
+
+		const Clock::time_point woke = Clock::now();
+		const Clock::duration overshoot = woke - now - slice;
+		sleep_overshoot = std::max(overshoot, sleep_overshoot - sleep_overshoot / 16);
+		now = woke;
+	}
+
+	while (Clock::now() < deadline) {
+		std::this_thread::yield();
+	}
+}
+
+void FramePacer::report(std::ostream& out, const char* name) const {
+	const size_t count = std::min(interval_count, intervals.size());
+	if (count == 0) {
+		return;
+	}
+
+	const double target = toMs(period);
+	double sum = 0;
+	double sum_squares = 0;
+	std::vector<double> deviations(count);
+	for (size_t i = 0; i < count; ++i) {
+		sum += intervals[i];
+		sum_squares += intervals[i] * static_cast<double>(intervals[i]);
+		deviations[i] = std::abs(intervals[i] - target);
+	}
+	const double mean = sum / count;
+	const double deviation = std::sqrt(std::max(0.0, sum_squares / count - mean * mean));
+
+	std::sort(deviations.begin(), deviations.end());
+	const double p99 = deviations[std::min(count - 1, count * 99 / 100)];
+
+	out << name << ": target " << target << " ms, mean " << mean
+		<< " ms, std dev " << deviation
+		<< " ms, jitter p99 " << p99
+		<< " ms, max " << deviations.back()
+		<< " ms over the last " << count << " frames" << std::endl;
+}
@@ -0,0 +1,51 @@
+#ifndef I3D_FRAMEPACER_H
+#define I3D_FRAMEPACER_H
+
+#include "Constants/RenderConstants.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+// Holds a loop to a target rate. wait() sleeps in short slices for most of
+// the remaining time and only yield-spins for the final stretch, which is
+// sized from how far past their requested length recent sleeps overshot,
+// so a paced loop leaves its core idle instead of busy-waiting. Each
+// interval between waits is kept for reporting how far the loop strayed
+// from its target.
+class FramePacer {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit FramePacer(double rate = 0);
+	~FramePacer();
+
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+
+	void setRate(double rate); // per second, 0 = unpaced
+	double getRate() const;
+
+	// Blocks until the next frame is due. If the loop has fallen more than a
+	// frame behind it starts over from now rather than rushing to catch up
+	void wait();
+
+	// Interval mean and deviation, and the 99th percentile and largest
+	// distance of an interval from the target
+	void report(std::ostream& out, const char* name) const;
+
+private:
+	void sleepUntil(Clock::time_point deadline);
+
+	Clock::duration period;
+	Clock::time_point deadline;
+	Clock::time_point last;
+	bool started;
+	Clock::duration sleep_overshoot;
+
+	std::array<float, PACER_HISTORY> intervals; // ms, a ring once full
+	size_t interval_count;
+};
+
+#endif // I3D_FRAMEPACER_H
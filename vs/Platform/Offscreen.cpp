@@ -0,0 +1,170 @@
+#include "Offscreen.h"
+#include "GlutHeaders.h"
+
+#include <iostream>
+
+#if __linux__
+#   include <EGL/egl.h>
+#   include <EGL/eglext.h>
+#endif
+
+Offscreen::Offscreen()
+	: width(0)
+	, height(0)
+	, display(nullptr)
+	, surface(nullptr)
+	, context(nullptr)
+	, framebuffer(0)
+	, colour_buffer(0)
+	, depth_buffer(0) {}
+
+Offscreen::~Offscreen() {
+	destroy();
+}
+
+bool Offscreen::create(int width, int height) {
+	this->width = width;
+	this->height = height;
+
+	if (!createContext()) {
+		destroy();
+		return false;
+	}
+
+	GLenum err = glewInit();
+	if (err != GLEW_OK) {
+		std::cerr << "GLEW: " << glewGetErrorString(err) << std::endl;
+		destroy();
+		return false;
+	}
+
+	if (!createFramebuffer()) {
+		destroy();
+		return false;
+	}
+	return true;
+}
+
+#if __linux__
+
+bool Offscreen::createContext() {
+	EGLDisplay egl_display = EGL_NO_DISPLAY;
+
+	// Surfaceless needs no X server or DRM device at all, so try it first
+	auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay != nullptr) {
+		egl_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if (egl_display == EGL_NO_DISPLAY || !eglInitialize(egl_display, nullptr, nullptr)) {
+		egl_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (egl_display == EGL_NO_DISPLAY || !eglInitialize(egl_display, nullptr, nullptr)) {
+			std::cerr << "Offscreen: no EGL display" << std::endl;
+			return false;
+		}
+	}
+	display = egl_display;
+
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		std::cerr << "Offscreen: EGL has no desktop OpenGL" << std::endl;
+		return false;
+	}
+
+	const EGLint config_attributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint config_count = 0;
+	if (!eglChooseConfig(egl_display, config_attributes, &config, 1, &config_count) || config_count == 0) {
+		std::cerr << "Offscreen: no suitable EGL config" << std::endl;
+		return false;
+	}
+
+	// The pbuffer is never drawn to, it only gives the context something to
+	// be current on for implementations without surfaceless support
+	const EGLint pbuffer_attributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+	EGLSurface egl_surface = eglCreatePbufferSurface(egl_display, config, pbuffer_attributes);
+	surface = egl_surface;
+
+	// Compatibility profile by default, which the fixed function code needs
+	EGLContext egl_context = eglCreateContext(egl_display, config, EGL_NO_CONTEXT, nullptr);
+	if (egl_context == EGL_NO_CONTEXT) {
+		std::cerr << "Offscreen: failed to create an EGL context" << std::endl;
+		return false;
+	}
+	context = egl_context;
+
+	if (!eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context)) {
+		std::cerr << "Offscreen: failed to make the EGL context current" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+#else
+
+bool Offscreen::createContext() {
+	std::cerr << "Offscreen: not supported on this platform" << std::endl;
+	return false;
+}
+
+#endif
+
+bool Offscreen::createFramebuffer() {
+	if (!(GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object)) {
+		std::cerr << "Offscreen: framebuffer objects not supported" << std::endl;
+		return false;
+	}
+
+	glGenRenderbuffers(1, &colour_buffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colour_buffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &depth_buffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colour_buffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cerr << "Offscreen: framebuffer incomplete" << std::endl;
+		return false;
+	}
+
+	// Stays bound for the rest of the run, so all drawing and reads go here
+	glViewport(0, 0, width, height);
+	return true;
+}
+
+void Offscreen::destroy() {
+	if (framebuffer != 0) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &colour_buffer);
+		glDeleteRenderbuffers(1, &depth_buffer);
+		framebuffer = colour_buffer = depth_buffer = 0;
+	}
+
+#if __linux__
+	if (display != nullptr) {
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (context != nullptr) {
+			eglDestroyContext(display, context);
+		}
+		if (surface != nullptr) {
+			eglDestroySurface(display, surface);
+		}
+		eglTerminate(display);
+	}
+#endif
+
+	display = surface = context = nullptr;
+}
+
+int Offscreen::getWidth() const { return width; }
+int Offscreen::getHeight() const { return height; }
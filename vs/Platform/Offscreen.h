@@ -0,0 +1,41 @@
+#ifndef I3D_OFFSCREEN_H
+#define I3D_OFFSCREEN_H
+
+// Headless alternative to the GLUT window. Creates a GL context through EGL
+// without any display server (Mesa's surfaceless platform, or a pbuffer on
+// the default display) and points all drawing at a framebuffer object of
+// the requested size. Only available where EGL is (Linux, linking -lEGL);
+// elsewhere create() reports the failure and returns false.
+class Offscreen {
+public:
+	Offscreen();
+	~Offscreen();
+
+	Offscreen(const Offscreen&) = delete;
+	Offscreen& operator=(const Offscreen&) = delete;
+
+	// Makes the context current on the calling thread, initialises GLEW and
+	// binds the framebuffer. Returns false if any step fails
+	bool create(int width, int height);
+	void destroy();
+
+	int getWidth() const;
+	int getHeight() const;
+
+private:
+	bool createContext();
+	bool createFramebuffer();
+
+	int width;
+	int height;
+
+	void* display;
+	void* surface;
+	void* context;
+
+	unsigned int framebuffer;
+	unsigned int colour_buffer;
+	unsigned int depth_buffer;
+};
+
+#endif // I3D_OFFSCREEN_H
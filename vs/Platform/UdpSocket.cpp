@@ -0,0 +1,210 @@
+#include "UdpSocket.h"
+#include "Constants/NetConstants.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#if _WIN32
+#   include <winsock2.h>
+#   include <ws2tcpip.h>
+#   pragma comment(lib, "ws2_32.lib")
+#else
+#   include <arpa/inet.h>
+#   include <cerrno>
+#   include <fcntl.h>
+#   include <netinet/in.h>
+#   include <sys/socket.h>
+#   include <unistd.h>
+#endif
+
+namespace {
+#if _WIN32
+	using Handle = SOCKET;
+	Handle constexpr NO_SOCKET = INVALID_SOCKET;
+
+	// Winsock has to be started before the first socket and stopped after
+	// the last, so the sockets count themselves
+	int open_sockets = 0;
+
+	bool startup() {
+		if (open_sockets++ == 0) {
+			WSADATA data;
+			if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+				--open_sockets;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void cleanup() {
+		if (--open_sockets == 0) {
+			WSACleanup();
+		}
+	}
+
+	void closeHandle(Handle handle) {
+		closesocket(handle);
+	}
+
+	bool setNonBlocking(Handle handle) {
+		u_long enabled = 1;
+		return ioctlsocket(handle, FIONBIO, &enabled) == 0;
+	}
+
+	bool wouldBlock() {
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+	}
+
+	// A previous send bouncing off a closed port shows up on the next receive
+	bool wasRefused() {
+		return WSAGetLastError() == WSAECONNRESET;
+	}
+#else
+	using Handle = int;
+	Handle constexpr NO_SOCKET = -1;
+
+	bool startup() {
+		return true;
+	}
+
+	void cleanup() {}
+
+	void closeHandle(Handle handle) {
+		::close(handle);
+	}
+
+	bool setNonBlocking(Handle handle) {
+		const int flags = fcntl(handle, F_GETFL, 0);
+		return flags != -1 && fcntl(handle, F_SETFL, flags | O_NONBLOCK) == 0;
+	}
+
+	bool wouldBlock() {
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+
+	bool wasRefused() {
+		return errno == ECONNREFUSED;
+	}
+#endif
+
+	Handle toHandle(std::intptr_t handle) {
+		return static_cast<Handle>(handle);
+	}
+
+	sockaddr_in toSockaddr(const NetAddress& address) {
+		sockaddr_in result;
+		std::memset(&result, 0, sizeof(result));
+		result.sin_family = AF_INET;
+		result.sin_addr.s_addr = htonl(address.host);
+		result.sin_port = htons(address.port);
+		return result;
+	}
+}
+
+bool NetAddress::parse(const std::string& text, NetAddress& address) {
+	const size_t colon = text.rfind(':');
+	if (colon == std::string::npos) {
+		return false;
+	}
+
+	const std::string host = text.substr(0, colon);
+	const long port = std::strtol(text.c_str() + colon + 1, nullptr, 10);
+	if (port <= 0 || port > 0xffff) {
+		return false;
+	}
+
+	in_addr parsed;
+	if (host == "localhost") {
+		parsed.s_addr = htonl(INADDR_LOOPBACK);
+	}
+	else if (inet_pton(AF_INET, host.c_str(), &parsed) != 1) {
+		return false;
+	}
+
+	address.host = ntohl(parsed.s_addr);
+	address.port = static_cast<std::uint16_t>(port);
+	return true;
+}
+
+std::string NetAddress::toString() const {
+	return std::to_string(host >> 24) + "." + std::to_string(host >> 16 & 0xff) + "."
+		+ std::to_string(host >> 8 & 0xff) + "." + std::to_string(host & 0xff) + ":" + std::to_string(port);
+}
+
+bool operator==(const NetAddress& lhs, const NetAddress& rhs) {
+	return lhs.host == rhs.host && lhs.port == rhs.port;
+}
+
+UdpSocket::UdpSocket()
+	: handle(static_cast<std::intptr_t>(NO_SOCKET)) {}
+
+UdpSocket::~UdpSocket() {
+	close();
+}
+
+bool UdpSocket::open(std::uint16_t port) {
+	close();
+	if (!startup()) {
+		std::cerr << "Couldn't start the socket library" << std::endl;
+		return false;
+	}
+
+	const Handle socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (socket == NO_SOCKET) {
+		std::cerr << "Couldn't create a UDP socket" << std::endl;
+		cleanup();
+		return false;
+	}
+	handle = static_cast<std::intptr_t>(socket);
+
+	// A keyframe to every client can land in the same tick; the default
+	// buffers drop some of them
+	const int buffer = NET_RECEIVE_BUFFER;
+	setsockopt(socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&buffer), sizeof(buffer));
+	setsockopt(socket, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&buffer), sizeof(buffer));
+
+	const sockaddr_in address = toSockaddr({ INADDR_ANY, port });
+	if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || !setNonBlocking(socket)) {
+		std::cerr << "Couldn't bind a UDP socket to port " << port << std::endl;
+		close();
+		return false;
+	}
+	return true;
+}
+
+void UdpSocket::close() {
+	if (toHandle(handle) == NO_SOCKET) {
+		return;
+	}
+	closeHandle(toHandle(handle));
+	handle = static_cast<std::intptr_t>(NO_SOCKET);
+	cleanup();
+}
+
+bool UdpSocket::send(const NetAddress& to, const unsigned char* data, size_t size) {
+	const sockaddr_in address = toSockaddr(to);
+	const auto sent = sendto(toHandle(handle), reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+		reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+	return sent == static_cast<std::remove_const_t<decltype(sent)>>(size);
+}
+
+long UdpSocket::receive(NetAddress& from, unsigned char* data, size_t capacity) {
+	while (true) {
+		sockaddr_in address;
+		socklen_t length = sizeof(address);
+		const auto received = recvfrom(toHandle(handle), reinterpret_cast<char*>(data), static_cast<int>(capacity), 0,
+			reinterpret_cast<sockaddr*>(&address), &length);
+		if (received >= 0) {
+			from.host = ntohl(address.sin_addr.s_addr);
+			from.port = ntohs(address.sin_port);
+			return static_cast<long>(received);
+		}
+		if (wouldBlock() || !wasRefused()) {
+			return -1;
+		}
+		// otherwise try the next datagram
+	}
+}
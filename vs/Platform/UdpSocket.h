@@ -0,0 +1,45 @@
+#ifndef I3D_UDPSOCKET_H
+#define I3D_UDPSOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// IPv4, both in host byte order
+struct NetAddress {
+	std::uint32_t host;
+	std::uint16_t port;
+
+	// "host:port", where host is dotted decimal or "localhost"
+	static bool parse(const std::string& text, NetAddress& address);
+	std::string toString() const;
+};
+
+bool operator==(const NetAddress& lhs, const NetAddress& rhs);
+
+// A non-blocking UDP socket over BSD sockets, or Winsock on Windows. Nothing
+// here retries or reorders; whatever sits on top has to cope with datagrams
+// going missing or turning up out of order.
+class UdpSocket {
+public:
+	UdpSocket();
+	~UdpSocket();
+
+	UdpSocket(const UdpSocket&) = delete;
+	UdpSocket& operator=(const UdpSocket&) = delete;
+
+	// Binds to port on every interface, or any free port if it's 0
+	bool open(std::uint16_t port);
+	void close();
+
+	bool send(const NetAddress& to, const unsigned char* data, size_t size);
+
+	// The size of the datagram read into data, or -1 if there's none waiting.
+	// Don't count on one bigger than capacity arriving at all
+	long receive(NetAddress& from, unsigned char* data, size_t capacity);
+
+private:
+	std::intptr_t handle;
+};
+
+#endif // I3D_UDPSOCKET_H
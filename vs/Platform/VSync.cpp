@@ -0,0 +1,34 @@
+#include "VSync.h"
+#include "GlutHeaders.h"
+
+// The window system halves of GLEW, whose function pointers glewInit() also
+// loads. These pull in Xlib's macros, so they stay out of GlutHeaders.h
+#if _WIN32
+#   include <GL/wglew.h>
+#elif __linux__
+#   include <GL/glxew.h>
+#endif
+
+bool vsync::setInterval(int interval) {
+#if _WIN32
+	if (WGLEW_EXT_swap_control) {
+		return wglSwapIntervalEXT(interval) == TRUE;
+	}
+#elif __linux__
+	// EXT is per drawable, so it needs the window's one to be current
+	Display* display = glXGetCurrentDisplay();
+	GLXDrawable drawable = glXGetCurrentDrawable();
+	if (GLXEW_EXT_swap_control && display != nullptr && drawable != 0) {
+		glXSwapIntervalEXT(display, drawable, interval);
+		return true;
+	}
+	if (GLXEW_MESA_swap_control) {
+		return glXSwapIntervalMESA(interval) == 0;
+	}
+	// SGI can't turn it off, only lengthen it
+	if (GLXEW_SGI_swap_control && interval > 0) {
+		return glXSwapIntervalSGI(interval) == 0;
+	}
+#endif
+	return false;
+}
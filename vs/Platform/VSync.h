@@ -0,0 +1,12 @@
+#ifndef I3D_VSYNC_H
+#define I3D_VSYNC_H
+
+namespace vsync {
+	// Sets how many vertical blanks each buffer swap waits for on the current
+	// context, 0 turning vsync off, through whichever of the EXT, MESA and SGI
+	// swap control extensions the driver has (WGL_EXT on Windows). Returns
+	// false if none of them took it
+	bool setInterval(int interval);
+}
+
+#endif // I3D_VSYNC_H
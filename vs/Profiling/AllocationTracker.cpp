@@ -0,0 +1,114 @@
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+void AllocationTracker::setEnabled(bool setting) {
+	enabled = setting;
+}
+
+bool AllocationTracker::isEnabled() {
+	return enabled;
+}
+
+AllocationTracker::Counts AllocationTracker::current() {
+	return counts;
+}
+
+void AllocationTracker::record(std::size_t bytes) {
+	if (!enabled.load(std::memory_order_relaxed) || suspended > 0) {
+		return;
+	}
+	++counts.allocations;
+	counts.bytes += bytes;
+}
+
+AllocationTracker::Suspend::Suspend() {
+	++suspended;
+}
+
+AllocationTracker::Suspend::~Suspend() {
+	--suspended;
+}
+
+AllocationTracker::SteadyState::SteadyState(const char* name)
+	: name(name)
+	, start(counts) {}
+
+AllocationTracker::SteadyState::~SteadyState() {
+	if (!enabled) {
+		return;
+	}
+
+	const std::uint64_t allocations = counts.allocations - start.allocations;
+	if (allocations == 0) {
+		return;
+	}
+
+	++violations;
+
+	Suspend suspend;
+	std::cerr << "Steady state section " << name << " allocated " << allocations << " times ("
+		<< counts.bytes - start.bytes << " bytes)" << std::endl;
+	if (strict) {
+		std::abort();
+	}
+}
+
+void AllocationTracker::setStrict(bool setting) {
+	strict = setting;
+}
+
+std::uint64_t AllocationTracker::getViolations() {
+	return violations;
+}
+
+void AllocationTracker::resetViolations() {
+	violations = 0;
+}
+
+// Replacements for the global allocation functions. The aligned overloads are
+// left alone; nothing in the game over-aligns, and their defaults pair up
+// among themselves so they don't have to be replaced alongside these.
+
+namespace {
+	void* allocate(std::size_t size) {
+		if (size == 0) {
+			size = 1;
+		}
+
+		void* pointer;
+		while ((pointer = std::malloc(size)) == nullptr) {
+			std::new_handler handler = std::get_new_handler();
+			if (handler == nullptr) {
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+
+		AllocationTracker::record(size);
+		return pointer;
+	}
+
+	void* allocate(std::size_t size, const std::nothrow_t&) noexcept {
+		try {
+			return allocate(size);
+		}
+		catch (const std::bad_alloc&) {
+			return nullptr;
+		}
+	}
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t& tag) noexcept { return allocate(size, tag); }
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return allocate(size, tag); }
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
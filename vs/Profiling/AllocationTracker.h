@@ -0,0 +1,62 @@
+#ifndef I3D_ALLOCATIONTRACKER_H
+#define I3D_ALLOCATIONTRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Counts heap allocations made through the global operator new, which is
+// replaced in AllocationTracker.cpp. Until setEnabled(true) the replacement
+// only forwards to malloc, so it costs one flag check per allocation.
+// Totals are per thread; Profiler scopes take the difference across their
+// lifetime to attribute allocations to a phase.
+class AllocationTracker {
+public:
+	struct Counts {
+		std::uint64_t allocations;
+		std::uint64_t bytes;
+	};
+
+	static void setEnabled(bool setting);
+	static bool isEnabled();
+
+	// This thread's running totals since it started
+	static Counts current();
+
+	// Called from operator new
+	static void record(std::size_t bytes);
+
+	// Allocations on this thread aren't counted while one of these is alive,
+	// for the bookkeeping of the tracker and profiler themselves
+	class Suspend {
+	public:
+		Suspend();
+		~Suspend();
+	};
+
+	// Marks a block that shouldn't allocate once the game is warmed up. Any
+	// allocation inside it counts as a violation, and aborts if strict
+	class SteadyState {
+	public:
+		explicit SteadyState(const char* name);
+		~SteadyState();
+
+	private:
+		const char* name;
+		Counts start;
+	};
+
+	static void setStrict(bool setting);
+	static std::uint64_t getViolations();
+	static void resetViolations();
+
+private:
+	inline static std::atomic<bool> enabled{ false };
+	inline static std::atomic<bool> strict{ false };
+	inline static std::atomic<std::uint64_t> violations{ 0 };
+
+	inline static thread_local Counts counts = { 0, 0 };
+	inline static thread_local int suspended = 0;
+};
+
+#endif // I3D_ALLOCATIONTRACKER_H
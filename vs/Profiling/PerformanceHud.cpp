@@ -0,0 +1,157 @@
+#include "PerformanceHud.h"
+#include "AllocationTracker.h"
+#include "GlutHeaders.h"
+
+#include <algorithm>
+#include <cstdio>
+
+PerformanceHud::PerformanceHud()
+	: visible(false)
+	, simulation()
+	, render()
+	, render_ms(0)
+	, render_allocations(0)
+	, last_update(std::chrono::steady_clock::now())
+	, frame_ms(0)
+	, hud_ms(0)
+	, frame_times()
+	, next_frame(0) {}
+
+void PerformanceHud::toggle() {
+	visible = !visible;
+}
+
+void PerformanceHud::setVisible(bool setting) {
+	visible = setting;
+}
+
+bool PerformanceHud::isVisible() const {
+	return visible;
+}
+
+void PerformanceHud::update(const FrameStats& simulation, const RenderStats& render,
+	double render_ms, std::uint64_t render_allocations) {
+	const auto now = std::chrono::steady_clock::now();
+	const std::chrono::duration<double, std::milli> interval = now - last_update;
+	last_update = now;
+
+	frame_ms = std::max(0.0, interval.count() - hud_ms);
+	frame_times[next_frame] = static_cast<float>(frame_ms);
+	next_frame = (next_frame + 1) % frame_times.size();
+
+	this->simulation = simulation;
+	this->render = render;
+	this->render_ms = render_ms;
+	this->render_allocations = render_allocations;
+}
+
+void PerformanceHud::draw() {
+	if (!visible) {
+		hud_ms = 0;
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_LINE_BIT);
+	glDisable(GL_LIGHTING);
+	glDisable(GL_TEXTURE_2D);
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_CULL_FACE);
+
+	// pixel coordinates, y down from the top left like the window's
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(0, viewport[2], viewport[3], 0, -1, 1);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	char line[128];
+	int y = HUD_MARGIN + HUD_LINE_HEIGHT;
+
+	std::snprintf(line, sizeof(line), "frame %6.2f ms  sim %5.2f  render %5.2f",
+		frame_ms, simulation.tick_ms, render_ms);
+	drawText(HUD_MARGIN, y, line);
+	y += HUD_LINE_HEIGHT;
+
+	std::snprintf(line, sizeof(line), "hud   %6.2f ms (not in frame)", hud_ms);
+	drawText(HUD_MARGIN, y, line);
+	y += HUD_LINE_HEIGHT;
+
+	std::snprintf(line, sizeof(line), "asteroids %u  bullets %u  particles %u  transparent %u",
+		simulation.asteroids, simulation.bullets, simulation.explosions, render.transparent);
+	drawText(HUD_MARGIN, y, line);
+	y += HUD_LINE_HEIGHT;
+
+	std::snprintf(line, sizeof(line), "draws %u  state changes %u  triangles %llu  culled %u",
+		render.draw_calls, render.state_changes, static_cast<unsigned long long>(render.triangles), render.culled);
+	drawText(HUD_MARGIN, y, line);
+	y += HUD_LINE_HEIGHT;
+
+	if (AllocationTracker::isEnabled()) {
+		std::snprintf(line, sizeof(line), "allocations %llu (sim %llu, render %llu)",
+			static_cast<unsigned long long>(simulation.allocations + render_allocations),
+			static_cast<unsigned long long>(simulation.allocations),
+			static_cast<unsigned long long>(render_allocations));
+	}
+	else {
+		std::snprintf(line, sizeof(line), "allocations n/a (--track-allocations)");
+	}
+	drawText(HUD_MARGIN, y, line);
+	y += HUD_LINE_HEIGHT / 2;
+
+	drawGraph(HUD_MARGIN, y + HUD_GRAPH_HEIGHT);
+
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+	glPopAttrib();
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	hud_ms = elapsed.count();
+}
+
+void PerformanceHud::drawText(int x, int y, const char* text) const {
+	glColor3f(1, 1, 0);
+	glRasterPos2i(x, y);
+	for (const char* c = text; *c != '\0'; ++c) {
+		glutBitmapCharacter(GLUT_BITMAP_8_BY_13, *c);
+	}
+}
+
+// One vertical line per frame, oldest on the left, from the baseline at y
+void PerformanceHud::drawGraph(int x, int y) const {
+	const float scale = HUD_GRAPH_HEIGHT / HUD_GRAPH_SCALE;
+	const int width = static_cast<int>(frame_times.size());
+
+	glLineWidth(1);
+	glBegin(GL_LINES);
+		glColor3f(0.3f, 0.3f, 0.3f);
+		glVertex2i(x, y);
+		glVertex2i(x + width, y);
+
+		for (size_t i = 0; i < frame_times.size(); ++i) {
+			const float ms = frame_times[(next_frame + i) % frame_times.size()];
+			const float height = std::min(ms, HUD_GRAPH_SCALE) * scale;
+			if (ms > HUD_TARGET_MS) {
+				glColor3f(1, 0.2f, 0.2f);
+			}
+			else {
+				glColor3f(0.2f, 1, 0.2f);
+			}
+			glVertex2f(x + i + 0.5f, static_cast<float>(y));
+			glVertex2f(x + i + 0.5f, y - height);
+		}
+
+		// the 60 Hz budget
+		const float target = y - HUD_TARGET_MS * scale;
+		glColor3f(1, 1, 1);
+		glVertex2f(static_cast<float>(x), target);
+		glVertex2f(static_cast<float>(x + width), target);
+	glEnd();
+}
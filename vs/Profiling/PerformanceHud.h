@@ -0,0 +1,53 @@
+#ifndef I3D_PERFORMANCEHUD_H
+#define I3D_PERFORMANCEHUD_H
+
+#include "Render/RenderFrame.h"
+#include "Render/Renderer.h"
+#include "Constants/RenderConstants.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// Overlay of what the last frame cost: frame, simulation and render times,
+// a graph of recent frame times, how much was drawn and what was allocated.
+// Lives on the GL thread. The frame time is the interval between update()
+// calls less however long the HUD itself took to draw in between, which is
+// shown on its own line. Text goes through fixed buffers, so showing the HUD
+// doesn't allocate either.
+class PerformanceHud {
+public:
+	PerformanceHud();
+
+	void toggle();
+	void setVisible(bool setting);
+	bool isVisible() const;
+
+	// Once per frame drawn, after the renderer has executed it
+	// render_allocations only means anything if the AllocationTracker is on
+	void update(const FrameStats& simulation, const RenderStats& render,
+		double render_ms, std::uint64_t render_allocations);
+
+	// Over whatever's in the viewport, so after the transparent pass. Needs
+	// GLUT to be initialised for its fonts
+	void draw();
+
+private:
+	void drawText(int x, int y, const char* text) const;
+	void drawGraph(int x, int y) const;
+
+	bool visible;
+
+	FrameStats simulation;
+	RenderStats render;
+	double render_ms;
+	std::uint64_t render_allocations;
+
+	std::chrono::steady_clock::time_point last_update;
+	double frame_ms;
+	double hud_ms; // the last draw(), taken back out of the next frame time
+	std::array<float, HUD_GRAPH_FRAMES> frame_times;
+	size_t next_frame; // oldest entry in frame_times
+};
+
+#endif // I3D_PERFORMANCEHUD_H
@@ -0,0 +1,70 @@
+#include "Profiler.h"
+
+Profiler::Scope::Scope(Phase phase)
+	: phase(phase)
+	, start(std::chrono::steady_clock::now())
+	, start_counts(AllocationTracker::current()) {}
+
+Profiler::Scope::~Scope() {
+	if (!enabled) {
+		return;
+	}
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	const AllocationTracker::Counts counts = AllocationTracker::current();
+
+	// growing the sample lists isn't the game's doing
+	AllocationTracker::Suspend suspend;
+	const size_t index = static_cast<size_t>(phase);
+	samples[index].push_back(elapsed.count());
+	if (AllocationTracker::isEnabled()) {
+		allocations[index].push_back(static_cast<double>(counts.allocations - start_counts.allocations));
+		allocated_bytes[index].push_back(static_cast<double>(counts.bytes - start_counts.bytes));
+	}
+}
+
+void Profiler::setEnabled(bool setting) {
+	enabled = setting;
+}
+
+void Profiler::reset() {
+	for (size_t phase = 0; phase < samples.size(); ++phase) {
+		samples[phase].clear();
+		allocations[phase].clear();
+		allocated_bytes[phase].clear();
+	}
+}
+
+const std::vector<double>& Profiler::getSamples(Phase phase) {
+	return samples[static_cast<size_t>(phase)];
+}
+
+const std::vector<double>& Profiler::getAllocations(Phase phase) {
+	return allocations[static_cast<size_t>(phase)];
+}
+
+const std::vector<double>& Profiler::getAllocatedBytes(Phase phase) {
+	return allocated_bytes[static_cast<size_t>(phase)];
+}
+
+const char* Profiler::getName(Phase phase) {
+	switch (phase) {
+	case Phase::update:
+		return "update";
+	case Phase::collisions:
+		return "collisions";
+	case Phase::input:
+		return "input";
+	case Phase::record:
+		return "record";
+	case Phase::tick:
+		return "tick";
+	case Phase::render:
+		return "render";
+	case Phase::snapshot:
+		return "snapshot";
+	case Phase::restore:
+		return "restore";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,58 @@
+#ifndef I3D_PROFILER_H
+#define I3D_PROFILER_H
+
+#include "AllocationTracker.h"
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+// The stages of a tick and of a frame that get timed
+enum class Phase {
+	update,
+	collisions,
+	input,
+	record,
+	tick, // all of the above, plus publishing the frame
+	render,
+	snapshot, // GameManager::saveSnapshot, whenever it's called
+	restore,
+	count
+};
+
+// Collects one duration sample per phase per tick while enabled, plus the
+// number and size of heap allocations made in it if the AllocationTracker
+// is on (nested phases count towards their parents too). Phases are
+// each only ever entered from one thread (render on the GL thread, the rest
+// on the simulation thread), so the sample lists don't need locking; just
+// don't enable, reset or read them while the game is running.
+class Profiler {
+public:
+	// Times the enclosing block
+	class Scope {
+	public:
+		explicit Scope(Phase phase);
+		~Scope();
+
+	private:
+		Phase phase;
+		std::chrono::steady_clock::time_point start;
+		AllocationTracker::Counts start_counts;
+	};
+
+	static void setEnabled(bool setting);
+	static void reset();
+
+	static const std::vector<double>& getSamples(Phase phase); // ms
+	static const std::vector<double>& getAllocations(Phase phase);
+	static const std::vector<double>& getAllocatedBytes(Phase phase);
+	static const char* getName(Phase phase);
+
+private:
+	inline static bool enabled = false;
+	inline static std::array<std::vector<double>, static_cast<size_t>(Phase::count)> samples;
+	inline static std::array<std::vector<double>, static_cast<size_t>(Phase::count)> allocations;
+	inline static std::array<std::vector<double>, static_cast<size_t>(Phase::count)> allocated_bytes;
+};
+
+#endif // I3D_PROFILER_H
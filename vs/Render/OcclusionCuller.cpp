@@ -0,0 +1,257 @@
+#include "OcclusionCuller.h"
+#include "Constants/RenderConstants.h"
+#include "Constants/AsteroidConstants.h"
+#include "Constants/CameraConstants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	// Columns of the transform have the scale as their length
+	float scaleOf(const matrix::Matrix& transform) {
+		return std::sqrt(transform[0] * transform[0] + transform[1] * transform[1] + transform[2] * transform[2]);
+	}
+}
+
+OcclusionCuller::OcclusionCuller(int workers)
+	: width(OCCLUSION_WIDTH)
+	, height(OCCLUSION_HEIGHT)
+	, depth_buffer(OCCLUSION_WIDTH * OCCLUSION_HEIGHT)
+	, x_scale(1)
+	, y_scale(1)
+	, culled(0)
+	, generation(0)
+	, remaining(0)
+	, stage(Stage::rasterise)
+	, stopping(false) {
+	occluders.reserve(RENDER_FRAME_ASTEROIDS);
+	occludees.reserve(RENDER_FRAME_COMMANDS);
+	occluded.reserve(RENDER_FRAME_COMMANDS);
+
+	for (int task = 1; task <= workers; ++task) {
+		this->workers.emplace_back(&OcclusionCuller::work, this, task);
+	}
+}
+
+OcclusionCuller::~OcclusionCuller() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+void OcclusionCuller::cull(const RenderFrame& frame, const float* projection, std::vector<sortkey::Item>& order) {
+	x_scale = projection[0];
+	y_scale = projection[5];
+	occluders.clear();
+	occludees.clear();
+	culled = 0;
+
+	// modelview = view_rotation * translation(-camera), looking down -z
+	const matrix::Matrix& view = frame.view_rotation;
+	const Vector3D& camera = frame.camera_position;
+	for (size_t i = 0; i < order.size(); ++i) {
+		const RenderCommand& command = frame.commands[order[i].index];
+		float radius;
+		switch (command.mesh) {
+		case Mesh::asteroid:
+			radius = scaleOf(command.transform);
+			break;
+		case Mesh::bullet:
+		case Mesh::explosion:
+			radius = scaleOf(command.transform) * 0.7072f; // corner of a unit quad
+			break;
+		default:
+			continue;
+		}
+
+		const float dx = command.transform[12] - camera.X;
+		const float dy = command.transform[13] - camera.Y;
+		const float dz = command.transform[14] - camera.Z;
+		Sphere sphere;
+		sphere.x = view[0] * dx + view[4] * dy + view[8] * dz;
+		sphere.y = view[1] * dx + view[5] * dy + view[9] * dz;
+		sphere.depth = -(view[2] * dx + view[6] * dy + view[10] * dz);
+		sphere.item = i;
+
+		// The lumps push out or in by up to the fudge, so test the most an
+		// asteroid could cover but rasterise the least
+		if (command.mesh == Mesh::asteroid) {
+			sphere.radius = radius * (1 - ASTEROID_FUDGE);
+			if (radius >= OCCLUSION_MIN_RADIUS && sphere.depth - sphere.radius > CAMERA_ZNEAR) {
+				occluders.push_back(sphere);
+			}
+			radius *= 1 + ASTEROID_FUDGE;
+		}
+		sphere.radius = radius;
+		occludees.push_back(sphere);
+	}
+
+	if (occluders.empty() || occludees.empty()) {
+		return;
+	}
+
+	auto covers_more = [](const Sphere& a, const Sphere& b) {
+		return a.radius / a.depth > b.radius / b.depth;
+	};
+	if (occluders.size() > OCCLUSION_MAX_OCCLUDERS) {
+		std::nth_element(occluders.begin(), occluders.begin() + OCCLUSION_MAX_OCCLUDERS, occluders.end(), covers_more);
+		occluders.resize(OCCLUSION_MAX_OCCLUDERS);
+	}
+
+	occluded.assign(occludees.size(), 0);
+	dispatch(Stage::rasterise);
+	dispatch(Stage::test);
+
+	// occludees were gathered in order, so one pass keeps the rest sorted
+	size_t next = 0;
+	size_t kept = 0;
+	for (size_t i = 0; i < order.size(); ++i) {
+		if (next < occludees.size() && occludees[next].item == i) {
+			if (occluded[next++]) {
+				continue;
+			}
+		}
+		order[kept++] = order[i];
+	}
+	culled = order.size() - kept;
+	order.resize(kept);
+}
+
+size_t OcclusionCuller::getOccluders() const {
+	return occluders.size();
+}
+
+size_t OcclusionCuller::getCulled() const {
+	return culled;
+}
+
+// The calling thread takes task 0, so with no workers it's all done inline
+void OcclusionCuller::dispatch(Stage stage) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->stage = stage;
+		++generation;
+		remaining = static_cast<int>(workers.size());
+	}
+	started.notify_all();
+
+	run(stage, 0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] { return remaining == 0; });
+}
+
+void OcclusionCuller::work(int task) {
+	unsigned int seen = 0;
+	while (true) {
+		Stage current;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			started.wait(lock, [this, seen] { return generation != seen || stopping; });
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+			current = stage;
+		}
+
+		run(current, task);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--remaining == 0) {
+			finished.notify_one();
+		}
+	}
+}
+
+void OcclusionCuller::run(Stage stage, int task) {
+	if (stage == Stage::rasterise) {
+		rasterise(task);
+	}
+	else {
+		test(task);
+	}
+}
+
+// Clears this task's rows and draws every occluder's disc into them. The disc
+// is an ellipse on the buffer, shrunk by a pixel's half diagonal so that only
+// pixels it covers completely take its depth
+void OcclusionCuller::rasterise(int task) {
+	const int tasks = static_cast<int>(workers.size()) + 1;
+	const int first_row = height * task / tasks;
+	const int last_row = height * (task + 1) / tasks;
+
+	std::fill(depth_buffer.begin() + first_row * width, depth_buffer.begin() + last_row * width,
+		std::numeric_limits<float>::max());
+
+	for (const Sphere& occluder : occluders) {
+		const float centre_x = (x_scale * occluder.x / occluder.depth + 1) * 0.5f * width;
+		const float centre_y = (y_scale * occluder.y / occluder.depth + 1) * 0.5f * height;
+		const float radius_x = x_scale * occluder.radius / occluder.depth * 0.5f * width - 0.75f;
+		const float radius_y = y_scale * occluder.radius / occluder.depth * 0.5f * height - 0.75f;
+		if (radius_x <= 0 || radius_y <= 0) {
+			continue;
+		}
+
+		const int top = std::max(first_row, static_cast<int>(std::ceil(centre_y - radius_y - 0.5f)));
+		const int bottom = std::min(last_row - 1, static_cast<int>(std::floor(centre_y + radius_y - 0.5f)));
+		for (int row = top; row <= bottom; ++row) {
+			const float v = (row + 0.5f - centre_y) / radius_y;
+			const float half_span = radius_x * std::sqrt(std::max(0.0f, 1 - v * v));
+			const int left = std::max(0, static_cast<int>(std::ceil(centre_x - half_span - 0.5f)));
+			const int right = std::min(width - 1, static_cast<int>(std::floor(centre_x + half_span - 0.5f)));
+
+			float* pixel = &depth_buffer[row * width];
+			for (int column = left; column <= right; ++column) {
+				pixel[column] = std::min(pixel[column], occluder.depth);
+			}
+		}
+	}
+}
+
+void OcclusionCuller::test(int task) {
+	const size_t tasks = workers.size() + 1;
+	const size_t first = occludees.size() * task / tasks;
+	const size_t last = occludees.size() * (task + 1) / tasks;
+	for (size_t i = first; i < last; ++i) {
+		occluded[i] = hidden(occludees[i]);
+	}
+}
+
+// Hidden if every pixel under the sphere's screen bounds has something in
+// front of its nearest point. The bounds come from the corners of the box
+// around it, at whichever of its near and far depths puts them further out
+bool OcclusionCuller::hidden(const Sphere& sphere) const {
+	const float near_depth = sphere.depth - sphere.radius;
+	if (near_depth <= CAMERA_ZNEAR) {
+		return false;
+	}
+	const float far_depth = sphere.depth + sphere.radius;
+
+	auto extent = [](float low, float high, float scale, float near_depth, float far_depth, int size, int& first, int& last) {
+		const float min = scale * std::min(low / near_depth, low / far_depth);
+		const float max = scale * std::max(high / near_depth, high / far_depth);
+		first = std::max(0, static_cast<int>(std::floor((min + 1) * 0.5f * size)));
+		last = std::min(size - 1, static_cast<int>(std::floor((max + 1) * 0.5f * size)));
+	};
+
+	int left, right, top, bottom;
+	extent(sphere.x - sphere.radius, sphere.x + sphere.radius, x_scale, near_depth, far_depth, width, left, right);
+	extent(sphere.y - sphere.radius, sphere.y + sphere.radius, y_scale, near_depth, far_depth, height, top, bottom);
+
+	for (int row = top; row <= bottom; ++row) {
+		const float* pixel = &depth_buffer[row * width];
+		for (int column = left; column <= right; ++column) {
+			if (pixel[column] >= near_depth) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
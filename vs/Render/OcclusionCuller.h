@@ -0,0 +1,83 @@
+#ifndef I3D_OCCLUSIONCULLER_H
+#define I3D_OCCLUSIONCULLER_H
+
+#include "RenderFrame.h"
+#include "SortKey.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Software occlusion culling on the CPU. Each frame the asteroids that
+// cover the most of the screen are rasterised into a small depth buffer,
+// each as the disc through its centre facing the camera, shrunk to what
+// its lumps can't dent. Every ray through that disc has met the asteroid
+// by the disc's depth, so the disc hides anything wholly behind it. The
+// bounding spheres of the other asteroids and the billboards are then
+// tested against the buffer, and whatever is hidden is dropped before
+// it's drawn. The buffer is rasterised in horizontal strips and the tests
+// split into slices, one of each per worker plus one on the calling thread.
+class OcclusionCuller {
+public:
+	explicit OcclusionCuller(int workers);
+	~OcclusionCuller();
+
+	OcclusionCuller(const OcclusionCuller&) = delete;
+	OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+	// projection is the column-major perspective matrix the frame is drawn
+	// with. Removes the hidden commands from order, keeping the rest in order
+	void cull(const RenderFrame& frame, const float* projection, std::vector<sortkey::Item>& order);
+
+	size_t getOccluders() const; // used in the last cull()
+	size_t getCulled() const;
+
+private:
+	// In view space: x, y and the distance in front of the camera
+	struct Sphere {
+		float x;
+		float y;
+		float depth;
+		float radius;
+		size_t item; // in order
+	};
+
+	enum class Stage {
+		rasterise,
+		test
+	};
+
+	void dispatch(Stage stage);
+	void work(int task);
+	void run(Stage stage, int task);
+
+	void rasterise(int task);
+	void test(int task);
+	bool hidden(const Sphere& sphere) const;
+
+	int width;
+	int height;
+	std::vector<float> depth_buffer; // view depth, row by row
+	float x_scale; // projection[0]
+	float y_scale; // projection[5]
+
+	std::vector<Sphere> occluders;
+	std::vector<Sphere> occludees;
+	std::vector<unsigned char> occluded; // one per occludee
+	size_t culled;
+
+	// The workers wait for the generation to change, run the stage for
+	// their task and count themselves off
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable started;
+	std::condition_variable finished;
+	unsigned int generation;
+	int remaining;
+	Stage stage;
+	bool stopping;
+};
+
+#endif // I3D_OCCLUSIONCULLER_H
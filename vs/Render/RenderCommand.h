@@ -0,0 +1,42 @@
+#ifndef I3D_RENDERCOMMAND_H
+#define I3D_RENDERCOMMAND_H
+
+#include "Math/Matrix.h"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// What a command draws. Each one maps onto a static render function that
+// only touches resources living for the whole game (buffers, textures, the
+// ship model), never the simulation object that recorded it
+enum class Mesh : std::uint8_t {
+	ship,
+	wall,
+	satellite,
+	asteroid,
+	skybox,
+	bullet,
+	explosion
+};
+
+// Coarse draw order; sits in the top bits of the sort key
+enum class RenderPass : std::uint8_t {
+	opaque,
+	skybox,
+	transparent
+};
+
+// Recorded by the simulation thread, executed by the render thread. Plain
+// data so a whole frame can be copied and handed across without locking
+struct RenderCommand {
+	std::uint64_t sort_key;
+	Mesh mesh;
+	unsigned int texture;
+	matrix::Matrix transform; // model -> world
+	std::array<float, 4> params; // per-mesh: colour, animation frame, texture layer ...
+};
+
+static_assert(std::is_trivially_copyable<RenderCommand>::value, "RenderCommand must stay POD");
+
+#endif // I3D_RENDERCOMMAND_H
@@ -0,0 +1,22 @@
+#include "RenderFrame.h"
+#include "SortKey.h"
+#include "Constants/RenderConstants.h"
+
+RenderFrame::RenderFrame() {
+	commands.reserve(RENDER_FRAME_COMMANDS);
+}
+
+// Keeps the command storage around so recording doesn't allocate once warm
+void RenderFrame::clear() {
+	commands.clear();
+}
+
+// The order commands are drawn in comes from their keys, whatever order
+// they're recorded in. Distance is to the command's origin, the translation
+// part of its transform
+void RenderFrame::record(RenderPass pass, Mesh mesh, unsigned int texture,
+	const matrix::Matrix& transform, const std::array<float, 4>& params, std::uint8_t material) {
+	const Vector3D origin(transform[12], transform[13], transform[14]);
+	const std::uint64_t key = sortkey::make(pass, mesh, texture, material, Vector3D::distance(camera_position, origin));
+	commands.push_back({ key, mesh, texture, transform, params });
+}
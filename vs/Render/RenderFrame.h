@@ -0,0 +1,38 @@
+#ifndef I3D_RENDERFRAME_H
+#define I3D_RENDERFRAME_H
+
+#include "RenderCommand.h"
+#include "Math/Vector3D.h"
+
+#include <cstdint>
+#include <vector>
+
+// The simulation's side of the performance HUD, from the tick that recorded
+// the frame
+struct FrameStats {
+	float tick_ms; // update, collisions and input, up to recording
+	std::uint64_t allocations; // on the simulation thread over the same span
+	std::uint32_t asteroids;
+	std::uint32_t bullets;
+	std::uint32_t explosions;
+};
+
+// Everything the renderer needs to draw one tick: the camera and the commands.
+// Set the camera first, as recording works out each command's distance from it
+class RenderFrame {
+public:
+	RenderFrame();
+
+	void clear();
+	// material separates opaque commands of one mesh and texture whose params
+	// set different state, e.g. a wall's colour
+	void record(RenderPass pass, Mesh mesh, unsigned int texture,
+		const matrix::Matrix& transform, const std::array<float, 4>& params = {}, std::uint8_t material = 0);
+
+	matrix::Matrix view_rotation; // camera's inverse rotation
+	Vector3D camera_position;
+	std::vector<RenderCommand> commands;
+	FrameStats stats = {};
+};
+
+#endif // I3D_RENDERFRAME_H
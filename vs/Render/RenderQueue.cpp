@@ -0,0 +1,49 @@
+#include "RenderQueue.h"
+
+#include <chrono>
+
+RenderQueue::RenderQueue()
+	: back_index(0)
+	, fresh(false)
+	, reading(false)
+	, stopped(false) {}
+
+RenderFrame& RenderQueue::back() {
+	return frames[back_index];
+}
+
+void RenderQueue::publish() {
+	std::unique_lock<std::mutex> lock(mutex);
+	changed.wait(lock, [this] { return !reading || stopped; });
+
+	back_index = 1 - back_index;
+	fresh = true;
+	frames[back_index].clear();
+
+	changed.notify_all();
+}
+
+RenderFrame* RenderQueue::acquire(int timeout_ms) {
+	std::unique_lock<std::mutex> lock(mutex);
+	changed.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return fresh || stopped; });
+
+	if (!fresh) {
+		return nullptr;
+	}
+
+	fresh = false;
+	reading = true;
+	return &frames[1 - back_index];
+}
+
+void RenderQueue::release() {
+	std::lock_guard<std::mutex> lock(mutex);
+	reading = false;
+	changed.notify_all();
+}
+
+void RenderQueue::stop() {
+	std::lock_guard<std::mutex> lock(mutex);
+	stopped = true;
+	changed.notify_all();
+}
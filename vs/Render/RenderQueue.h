@@ -0,0 +1,40 @@
+#ifndef I3D_RENDERQUEUE_H
+#define I3D_RENDERQUEUE_H
+
+#include "RenderFrame.h"
+
+#include <array>
+#include <mutex>
+#include <condition_variable>
+
+// Double buffer between the simulation and render threads. The simulation
+// records tick N+1 into the back frame while the renderer draws tick N from
+// the front one; publish() swaps them once the renderer has let go.
+class RenderQueue {
+public:
+	RenderQueue();
+
+	// simulation side
+	RenderFrame& back();
+	void publish();
+
+	// render side. acquire() waits up to timeout_ms for a frame it hasn't
+	// seen yet and returns nullptr if none arrived
+	RenderFrame* acquire(int timeout_ms);
+	void release();
+
+	// wakes up anything blocked so both threads can exit
+	void stop();
+
+private:
+	std::array<RenderFrame, 2> frames;
+	int back_index;
+	bool fresh;
+	bool reading;
+	bool stopped;
+
+	std::mutex mutex;
+	std::condition_variable changed;
+};
+
+#endif // I3D_RENDERQUEUE_H
@@ -0,0 +1,183 @@
+#include "Renderer.h"
+#include "GlutHeaders.h"
+
+#include "Arena/Wall.h"
+#include "Arena/Satellite.h"
+#include "Arena/Skybox.h"
+#include "Animation/AnimationDrawer.h"
+#include "Profiling/AllocationTracker.h"
+#include "Constants/RenderConstants.h"
+
+#include <algorithm>
+#include <thread>
+
+Renderer::Renderer()
+	: asteroid_renderer(std::make_unique<AsteroidRenderer>())
+	, occlusion_culling(OCCLUSION_CULLING)
+	, bound_texture(0)
+	, asteroids_in_run(0)
+	, stats() {
+	// One core for the simulation and one for this thread, any others can help cull
+	const int spare = static_cast<int>(std::thread::hardware_concurrency()) - 2;
+	occlusion_culler = std::make_unique<OcclusionCuller>(std::clamp(spare, 0, OCCLUSION_MAX_WORKERS));
+
+	order.reserve(RENDER_FRAME_COMMANDS);
+	scratch.reserve(RENDER_FRAME_COMMANDS);
+
+	Wall::buildGrid();
+}
+
+void Renderer::execute(RenderFrame& frame) {
+	AllocationTracker::SteadyState steady_state("render");
+
+	const std::vector<RenderCommand>& commands = frame.commands;
+	order.clear();
+	for (size_t i = 0; i < commands.size(); ++i) {
+		order.push_back({ commands[i].sort_key, static_cast<std::uint32_t>(i) });
+	}
+	sortkey::sort(order, scratch);
+	bound_texture = 0;
+	stats = {};
+
+	if (occlusion_culling) {
+		float projection[16];
+		glGetFloatv(GL_PROJECTION_MATRIX, projection);
+		occlusion_culler->cull(frame, projection, order);
+		stats.culled = static_cast<std::uint32_t>(occlusion_culler->getCulled());
+	}
+	stats.commands = static_cast<std::uint32_t>(order.size());
+
+	glMatrixMode(GL_MODELVIEW);
+	glLoadMatrixf(frame.view_rotation.data());
+	glTranslatef(-frame.camera_position.X, -frame.camera_position.Y, -frame.camera_position.Z);
+
+	float position0[] = { 1.0, 0.0, 0.0, 0.0 };
+	glLightfv(GL_LIGHT0, GL_POSITION, position0);
+
+	for (size_t i = 0; i < order.size(); ++i) {
+		const RenderCommand& command = commands[order[i].index];
+		if (i == 0 || commands[order[i - 1].index].mesh != command.mesh) {
+			begin(command.mesh);
+		}
+
+		draw(command);
+
+		if (i + 1 == order.size() || commands[order[i + 1].index].mesh != command.mesh) {
+			end(command.mesh);
+		}
+	}
+}
+
+void Renderer::setOcclusionCulling(bool setting) {
+	occlusion_culling = setting;
+}
+
+const OcclusionCuller& Renderer::getOcclusionCuller() const {
+	return *occlusion_culler;
+}
+
+const RenderStats& Renderer::getStats() const {
+	return stats;
+}
+
+void Renderer::begin(Mesh mesh) {
+	++stats.state_changes;
+	switch (mesh) {
+	case Mesh::wall:
+		Wall::bindGrid();
+		break;
+	case Mesh::asteroid:
+		asteroid_renderer->begin();
+		asteroids_in_run = 0;
+		break;
+	case Mesh::bullet:
+	case Mesh::explosion:
+		AnimationDrawer::begin();
+		bound_texture = 0; // whatever the meshes in between bound
+		break;
+	default:
+		break;
+	}
+}
+
+void Renderer::draw(const RenderCommand& command) {
+	switch (command.mesh) {
+	case Mesh::asteroid:
+		asteroid_renderer->add(command);
+		++asteroids_in_run;
+		return;
+	case Mesh::skybox:
+		// only the view rotation, the skybox never gets closer
+		glPushMatrix();
+			glLoadMatrixf(command.transform.data());
+			Skybox::render(command.texture);
+		glPopMatrix();
+		++stats.draw_calls;
+		stats.triangles += 12;
+		return;
+	default:
+		break;
+	}
+
+	glPushMatrix();
+		glMultMatrixf(command.transform.data());
+
+		switch (command.mesh) {
+		case Mesh::ship:
+			ship_model.render();
+			stats.draw_calls += static_cast<std::uint32_t>(ship_model.getTriangleCount());
+			stats.state_changes += static_cast<std::uint32_t>(ship_model.getTriangleCount());
+			stats.triangles += ship_model.getTriangleCount();
+			break;
+		case Mesh::wall:
+			Wall::render(command.params);
+			++stats.draw_calls;
+			break;
+		case Mesh::satellite:
+			Satellite::render(command.params);
+			++stats.draw_calls;
+			stats.triangles += Satellite::getTriangleCount();
+			break;
+		case Mesh::bullet:
+		case Mesh::explosion:
+			if (command.texture != bound_texture) {
+				glBindTexture(GL_TEXTURE_2D, command.texture);
+				bound_texture = command.texture;
+				++stats.state_changes;
+			}
+			AnimationDrawer::render(command.params);
+			++stats.draw_calls;
+			++stats.transparent;
+			stats.triangles += 2;
+			break;
+		default:
+			break;
+		}
+	glPopMatrix();
+}
+
+void Renderer::end(Mesh mesh) {
+	switch (mesh) {
+	case Mesh::wall:
+		Wall::unbindGrid();
+		break;
+	case Mesh::asteroid:
+		asteroid_renderer->end();
+		// one instanced draw, or one draw and bind each
+		if (asteroid_renderer->isInstanced()) {
+			stats.draw_calls += asteroids_in_run > 0 ? 1 : 0;
+		}
+		else {
+			stats.draw_calls += static_cast<std::uint32_t>(asteroids_in_run);
+			stats.state_changes += static_cast<std::uint32_t>(asteroids_in_run);
+		}
+		stats.triangles += asteroids_in_run * asteroid_renderer->getTrianglesPerAsteroid();
+		break;
+	case Mesh::bullet:
+	case Mesh::explosion:
+		AnimationDrawer::end();
+		break;
+	default:
+		break;
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef I3D_RENDERER_H
+#define I3D_RENDERER_H
+
+#include "RenderFrame.h"
+#include "SortKey.h"
+#include "OcclusionCuller.h"
+#include "Asteroids/AsteroidRenderer.h"
+#include "Ship/ShipModel.h"
+
+#include <memory>
+#include <vector>
+
+// What the last execute() issued, for the performance HUD. A state change is
+// the setup around a run of one mesh, a texture bind, or one of the ship's
+// per-triangle material switches
+struct RenderStats {
+	std::uint32_t commands; // left after culling
+	std::uint32_t culled;
+	std::uint32_t transparent;
+	std::uint32_t draw_calls;
+	std::uint32_t state_changes;
+	std::uint64_t triangles;
+};
+
+// Render thread side of the pipeline. Walks a recorded frame in sort key
+// order and issues the GL calls, setting up shared state once per run of
+// commands that draw the same mesh and binding textures only as they change.
+class Renderer {
+public:
+	Renderer();
+
+	void execute(RenderFrame& frame);
+
+	void setOcclusionCulling(bool setting);
+	const OcclusionCuller& getOcclusionCuller() const;
+	const RenderStats& getStats() const;
+
+private:
+	void begin(Mesh mesh);
+	void draw(const RenderCommand& command);
+	void end(Mesh mesh);
+
+	ShipModel ship_model;
+	std::unique_ptr<AsteroidRenderer> asteroid_renderer;
+	std::unique_ptr<OcclusionCuller> occlusion_culler;
+	bool occlusion_culling;
+
+	std::vector<sortkey::Item> order; // reused every frame
+	std::vector<sortkey::Item> scratch;
+	unsigned int bound_texture;
+	size_t asteroids_in_run;
+	RenderStats stats;
+};
+
+#endif // I3D_RENDERER_H
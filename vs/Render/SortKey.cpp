@@ -0,0 +1,72 @@
+#include "SortKey.h"
+#include "Constants/CameraConstants.h"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+	int constexpr DEPTH_BITS = 24;
+	std::uint64_t constexpr DEPTH_MAX = (std::uint64_t(1) << DEPTH_BITS) - 1;
+
+	// Anything past the far plane isn't drawn, so it can all share the last step
+	std::uint64_t quantise(float distance) {
+		const float scaled = distance / CAMERA_ZFAR * DEPTH_MAX;
+		return static_cast<std::uint64_t>(std::clamp(scaled, 0.0f, static_cast<float>(DEPTH_MAX)));
+	}
+}
+
+std::uint64_t sortkey::make(RenderPass pass, Mesh mesh, unsigned int texture, std::uint8_t material, float distance) {
+	const std::uint64_t key = static_cast<std::uint64_t>(pass) << 56;
+	switch (pass) {
+	case RenderPass::opaque:
+		return key
+			| static_cast<std::uint64_t>(mesh) << 48
+			| static_cast<std::uint64_t>(texture & 0xFFFF) << 32
+			| static_cast<std::uint64_t>(material) << 24
+			| quantise(distance);
+	case RenderPass::transparent:
+		return key | (DEPTH_MAX - quantise(distance));
+	default:
+		return key;
+	}
+}
+
+RenderPass sortkey::pass(std::uint64_t key) {
+	return static_cast<RenderPass>(key >> 56);
+}
+
+void sortkey::sort(std::vector<Item>& items, std::vector<Item>& scratch) {
+	if (items.size() < 2) {
+		return;
+	}
+
+	std::uint64_t all = ~std::uint64_t(0);
+	std::uint64_t any = 0;
+	for (const Item& item : items) {
+		all &= item.key;
+		any |= item.key;
+	}
+	const std::uint64_t varying = all ^ any;
+
+	scratch.resize(items.size());
+	for (int shift = 0; shift < 64; shift += 8) {
+		if (((varying >> shift) & 0xFF) == 0) {
+			continue;
+		}
+
+		std::array<size_t, 256> offsets = {};
+		for (const Item& item : items) {
+			++offsets[(item.key >> shift) & 0xFF];
+		}
+		size_t total = 0;
+		for (size_t& offset : offsets) {
+			const size_t count = offset;
+			offset = total;
+			total += count;
+		}
+		for (const Item& item : items) {
+			scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+		}
+		items.swap(scratch);
+	}
+}
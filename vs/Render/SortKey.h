@@ -0,0 +1,38 @@
+#ifndef I3D_SORTKEY_H
+#define I3D_SORTKEY_H
+
+#include "RenderCommand.h"
+
+#include <cstdint>
+#include <vector>
+
+// Packing of a RenderCommand's sort key, most significant first:
+//
+//	opaque		pass:8 | mesh:8 | texture:16 | material:8 | depth:24
+//	skybox		pass:8 | 0
+//	transparent	pass:8 | 0 | far-to-near depth:24
+//
+// The mesh stands in for the shader, being what picks the state the renderer
+// sets up around a run of commands, so sorting groups the most expensive
+// changes together first. Inside a bucket that shares all of its state the
+// opaque ones go nearest first, for the depth test to reject what's behind;
+// the transparent ones only care about depth, furthest first for blending.
+namespace sortkey {
+	std::uint64_t make(RenderPass pass, Mesh mesh, unsigned int texture, std::uint8_t material, float distance);
+
+	RenderPass pass(std::uint64_t key);
+
+	// A key and where its command is, so sorting moves 16 bytes a command
+	// rather than the whole thing
+	struct Item {
+		std::uint64_t key;
+		std::uint32_t index;
+	};
+
+	// Stable LSD radix sort, a byte at a time, skipping any byte that's the
+	// same in every key. scratch is only working space, kept between frames
+	// so that neither grows once warm
+	void sort(std::vector<Item>& items, std::vector<Item>& scratch);
+}
+
+#endif // I3D_SORTKEY_H
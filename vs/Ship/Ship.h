@@ -6,15 +6,10 @@
 #include "Math/Vector3D.h"
 #include "Math/Quaternion.h"
 
-#include "Arena/Wall.h"
-
-#include <vector>
-
-#include "Model/Triangle.h"
-#include "Model/Model.h"
-#include "Model/Material.h"
-
-#include "Bullets/BulletStream.h"
+#include "ECS/World.h"
+#include "ECS/Components.h"
+#include "Render/RenderFrame.h"
+#include "State/WorldState.h"
 
 enum class Axis {
 	x,
@@ -27,47 +22,39 @@ enum class Direction {
 	backward
 };
 
-class Ship {
-public:
-	Ship();
-
-	void update(const float dt);
-	void draw() const;
-	void updateBullets(const float dt);
-
-	void move(Direction direction, float dt);
-	void setAccelerationToZero();
-	void roll(const Axis axis, const float dt);
-	void rotate(const Axis axis, const float dt, const float map, const float speed = MOUSE_ROTATION_SPEED);
-	void shoot(float dt);
-
-	std::vector<std::shared_ptr<Bullet>>& getBullets();
-	const Vector3D& getPosition() const;
-	const Quaternion& getRotation() const;
-	const float& getWarningRadius() const;
-	const float& getCollisionRadius() const;
-
-	void reset();
-
-private:
-	Vector3D position;
+// Marks the entity the player flies, and holds what only it has. Besides
+// this it has a Position, but no Velocity; it goes where the input takes it
+// rather than drifting with systems::integrate. Its model is the renderer's
+// ShipModel, which is loaded once and never changes
+struct Ship {
 	Vector3D velocity;
 	Vector3D acceleration;
 	Quaternion rotation;
 
-	BulletStream bullet_stream;
-
 	float warning_radius;
 	float collision_radius;
 	float fire_timer;
 	float fire_rate;
 
 	unsigned int logo;
-	std::vector<Vector3D> vertices;
-	std::vector<Vector3D> uvs;
-	std::vector<Vector3D> normals;
-	std::vector<Triangle> triangles;
-	std::vector<Material> materials;
 };
 
-#endif // I3D_SHIP_H
\ No newline at end of file
+namespace ship {
+	// At the centre of the arena, facing forward
+	ecs::EntityId create(ecs::World& world);
+
+	void update(ecs::World& world, float dt);
+	void record(ecs::World& world, RenderFrame& frame);
+
+	void move(const Ship& ship, Position& position, Direction direction, float dt);
+	void setAccelerationToZero(Ship& ship);
+	void roll(Ship& ship, const Axis axis, const float dt);
+	void rotate(Ship& ship, const Axis axis, const float dt, const float map, const float speed = MOUSE_ROTATION_SPEED);
+	void shoot(ecs::World& world, Ship& ship, const Position& position);
+
+	// Where it is and how it's moving
+	void captureState(const Ship& ship, const Position& position, WorldState& state);
+	void applyState(Ship& ship, Position& position, const WorldState& state);
+}
+
+#endif // I3D_SHIP_H
@@ -0,0 +1,30 @@
+#ifndef I3D_SHIPMODEL_H
+#define I3D_SHIPMODEL_H
+
+#include "Math/Vector3D.h"
+
+#include "Model/Triangle.h"
+#include "Model/Model.h"
+#include "Model/Material.h"
+
+#include <vector>
+
+// The ship's mesh, loaded once by the renderer and drawn wherever each
+// recorded Mesh::ship command puts it
+class ShipModel {
+public:
+	ShipModel();
+
+	void render() const; // render thread, model space
+	size_t getTriangleCount() const; // each its own draw
+
+private:
+	unsigned int logo;
+	std::vector<Vector3D> vertices;
+	std::vector<Vector3D> uvs;
+	std::vector<Vector3D> normals;
+	std::vector<Triangle> triangles;
+	std::vector<Material> materials;
+};
+
+#endif // I3D_SHIPMODEL_H
@@ -0,0 +1,57 @@
+#include "Snapshot.h"
+
+Snapshot::Reader::Reader(const Snapshot& snapshot)
+	: bytes(snapshot.bytes)
+	, at(0)
+	, failed(false) {}
+
+void Snapshot::Reader::read(void* data, size_t bytes) {
+	if (bytes == 0) {
+		return;
+	}
+	if (bytes > remaining()) {
+		std::memset(data, 0, bytes);
+		failed = true;
+		at = this->bytes.size();
+		return;
+	}
+	std::memcpy(data, this->bytes.data() + at, bytes);
+	at += bytes;
+}
+
+size_t Snapshot::Reader::remaining() const {
+	return bytes.size() - at;
+}
+
+bool Snapshot::Reader::hasFailed() const {
+	return failed;
+}
+
+void Snapshot::clear() {
+	bytes.clear();
+}
+
+void Snapshot::write(const void* data, size_t bytes) {
+	if (bytes == 0) {
+		return;
+	}
+	const size_t offset = this->bytes.size();
+	this->bytes.resize(offset + bytes);
+	std::memcpy(this->bytes.data() + offset, data, bytes);
+}
+
+bool Snapshot::isEmpty() const {
+	return bytes.empty();
+}
+
+size_t Snapshot::size() const {
+	return bytes.size();
+}
+
+const unsigned char* Snapshot::data() const {
+	return bytes.data();
+}
+
+void Snapshot::assign(const unsigned char* data, size_t bytes) {
+	this->bytes.assign(data, data + bytes);
+}
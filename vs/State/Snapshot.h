@@ -0,0 +1,93 @@
+#ifndef I3D_SNAPSHOT_H
+#define I3D_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// A moment of play flattened into one contiguous buffer, for rolling the game
+// back to it later. Each part of the game writes its own state in turn and
+// reads it back in the same order. Assets aren't in here, only the ids they
+// were given, so a snapshot is only good for the process that took it.
+//
+// Values are copied in as raw bytes, so they have to be trivially copyable.
+// The buffer keeps its capacity across clear(), so taking snapshots of a game
+// that isn't growing doesn't allocate.
+class Snapshot {
+public:
+	// Reads a snapshot back from the start. Reading past the end gives zeroes
+	// and marks the reader failed rather than overrunning
+	class Reader {
+	public:
+		explicit Reader(const Snapshot& snapshot);
+
+		void read(void* data, size_t bytes);
+
+		template <typename T>
+		void read(T& value) {
+			static_assert(std::is_trivially_copyable_v<T>, "snapshots hold raw bytes");
+			read(&value, sizeof(T));
+		}
+
+		template <typename T>
+		void readVector(std::vector<T>& values) {
+			static_assert(std::is_trivially_copyable_v<T>, "snapshots hold raw bytes");
+			std::size_t count = 0;
+			read(count);
+			if (count * sizeof(T) > remaining()) {
+				failed = true;
+				count = 0;
+			}
+			if constexpr (std::is_default_constructible_v<T>) {
+				values.resize(count);
+				read(values.data(), count * sizeof(T));
+			}
+			else {
+				// one at a time, as there's nothing to resize to
+				values.clear();
+				values.reserve(count);
+				for (size_t i = 0; i < count; ++i) {
+					alignas(T) unsigned char element[sizeof(T)];
+					read(element, sizeof(T));
+					values.push_back(*reinterpret_cast<const T*>(element));
+				}
+			}
+		}
+
+		size_t remaining() const;
+		bool hasFailed() const;
+
+	private:
+		const std::vector<unsigned char>& bytes;
+		size_t at;
+		bool failed;
+	};
+
+	void clear();
+	void write(const void* data, size_t bytes);
+
+	template <typename T>
+	void write(const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>, "snapshots hold raw bytes");
+		write(&value, sizeof(T));
+	}
+
+	// The count, then the elements
+	template <typename T>
+	void writeVector(const std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable_v<T>, "snapshots hold raw bytes");
+		write(values.size());
+		write(values.data(), values.size() * sizeof(T));
+	}
+
+	bool isEmpty() const;
+	size_t size() const; // bytes
+	const unsigned char* data() const;
+	void assign(const unsigned char* data, size_t bytes);
+
+private:
+	std::vector<unsigned char> bytes;
+};
+
+#endif // I3D_SNAPSHOT_H
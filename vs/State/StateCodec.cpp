@@ -0,0 +1,412 @@
+#include "StateCodec.h"
+#include "Constants/StateConstants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+using statestream::Entity;
+using statestream::State;
+using statestream::HEADER_FIELDS;
+using statestream::ENTITY_FIELDS;
+using statestream::SPAWN_FIELDS;
+using statestream::putVarint;
+
+namespace {
+	std::int32_t quantise(float value, float step) {
+		return static_cast<std::int32_t>(std::lround(value / step));
+	}
+
+	float dequantise(std::int32_t value, float step) {
+		return value * step;
+	}
+
+	// Bit for bit, for values that either never change after they're set or
+	// have to come back exactly
+	std::int32_t toBits(float value) {
+		std::int32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	float fromBits(std::int32_t bits) {
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	// Asteroids' spin only ever grows, so it's wrapped before it's stored
+	std::int32_t quantiseAngle(float degrees) {
+		float wrapped = std::fmod(degrees, 360.0f);
+		if (wrapped < 0) {
+			wrapped += 360;
+		}
+		return quantise(wrapped, STATE_ANGLE_STEP);
+	}
+
+	// zigzag, so small differences either way stay short
+	void putSigned(std::vector<unsigned char>& out, std::int64_t value) {
+		putVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+	}
+
+	// Reads an encoded state, failing rather than running off the end
+	class Payload {
+	public:
+		Payload(const unsigned char* data, size_t size) : data(data), size(size), at(0) {}
+
+		bool varint(std::uint64_t& value) {
+			value = 0;
+			for (int shift = 0; shift < 64 && at < size; shift += 7) {
+				const unsigned char byte = data[at++];
+				value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool signedVarint(std::int64_t& value) {
+			std::uint64_t zigzag;
+			if (!varint(zigzag)) {
+				return false;
+			}
+			value = static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+			return true;
+		}
+
+		bool byte(std::uint8_t& value) {
+			if (at >= size) {
+				return false;
+			}
+			value = data[at++];
+			return true;
+		}
+
+		size_t remaining() const {
+			return size - at;
+		}
+
+	private:
+		const unsigned char* data;
+		size_t size;
+		size_t at;
+	};
+
+	// A bit mask of the fields that differ from previous, then the difference
+	// for each of those
+	template <size_t N>
+	void putFields(std::vector<unsigned char>& out,
+		const std::array<std::int32_t, N>& previous, const std::array<std::int32_t, N>& current) {
+		std::uint64_t mask = 0;
+		for (size_t i = 0; i < N; ++i) {
+			if (current[i] != previous[i]) {
+				mask |= 1ull << i;
+			}
+		}
+		putVarint(out, mask);
+		for (size_t i = 0; i < N; ++i) {
+			if (mask >> i & 1) {
+				putSigned(out, static_cast<std::int64_t>(current[i]) - previous[i]);
+			}
+		}
+	}
+
+	template <size_t N>
+	bool getFields(Payload& in, const std::array<std::int32_t, N>& previous, std::array<std::int32_t, N>& current) {
+		std::uint64_t mask;
+		if (!in.varint(mask) || (mask >> N) != 0) {
+			return false;
+		}
+		for (size_t i = 0; i < N; ++i) {
+			std::int64_t difference = 0;
+			if ((mask >> i & 1) && !in.signedVarint(difference)) {
+				return false;
+			}
+			current[i] = static_cast<std::int32_t>(previous[i] + difference);
+		}
+		return true;
+	}
+
+	const std::array<std::int32_t, ENTITY_FIELDS> NO_FIELDS = {};
+	const std::array<std::int32_t, SPAWN_FIELDS> NO_SPAWN = {};
+
+	// Calls visit(before, after) for every id in either list, with nullptr
+	// for the side it's missing from
+	template <typename Visit>
+	void match(const std::vector<Entity>& previous, const std::vector<Entity>& current, Visit&& visit) {
+		size_t i = 0;
+		size_t j = 0;
+		while (i < previous.size() || j < current.size()) {
+			if (j == current.size() || (i < previous.size() && previous[i].id < current[j].id)) {
+				visit(&previous[i++], nullptr);
+			}
+			else if (i == previous.size() || current[j].id < previous[i].id) {
+				visit(nullptr, &current[j++]);
+			}
+			else if (previous[i].kind != current[j].kind || previous[i].spawn != current[j].spawn) {
+				// Entity ids come back around once a snapshot restore takes the
+				// world back, on whatever is made next, so that's one leaving
+				// and another arriving rather than the same one moving
+				visit(&previous[i++], nullptr);
+				visit(nullptr, &current[j++]);
+			}
+			else {
+				visit(&previous[i++], &current[j++]);
+			}
+		}
+	}
+
+	// The header's fields, in order. dequantiseHeader has to read them back the same way
+	void quantiseHeader(const WorldState& state, std::array<std::int32_t, HEADER_FIELDS>& header) {
+		size_t i = 0;
+		auto put = [&header, &i](std::int32_t value) { header[i++] = value; };
+		auto putVector = [&put](const Vector3D& v, float step) {
+			put(quantise(v.X, step));
+			put(quantise(v.Y, step));
+			put(quantise(v.Z, step));
+		};
+		auto putRotation = [&put](const Quaternion& q) {
+			put(quantise(q.getX(), STATE_ROTATION_STEP));
+			put(quantise(q.getY(), STATE_ROTATION_STEP));
+			put(quantise(q.getZ(), STATE_ROTATION_STEP));
+			put(quantise(q.getW(), STATE_ROTATION_STEP));
+		};
+		auto putBits = [&put](const Vector3D& v) {
+			put(toBits(v.X));
+			put(toBits(v.Y));
+			put(toBits(v.Z));
+		};
+
+		put(toBits(state.dt));
+		putVector(state.ship_position, STATE_POSITION_STEP);
+		putVector(state.ship_velocity, STATE_VELOCITY_STEP);
+		putRotation(state.ship_rotation);
+		putVector(state.camera_position, STATE_POSITION_STEP);
+		putRotation(state.camera_rotation);
+		putBits(state.satellite_position);
+		putBits(state.satellite_axis);
+		put(quantiseAngle(state.satellite_angle));
+		put(state.red_walls);
+		put(static_cast<std::int32_t>(std::lround(state.asteroid_count)));
+		put(quantise(state.level_timer, STATE_TIMER_STEP));
+	}
+
+	void dequantiseHeader(const std::array<std::int32_t, HEADER_FIELDS>& header, WorldState& state) {
+		size_t i = 0;
+		auto get = [&header, &i]() { return header[i++]; };
+		auto getVector = [&get](float step) {
+			const float x = dequantise(get(), step);
+			const float y = dequantise(get(), step);
+			const float z = dequantise(get(), step);
+			return Vector3D(x, y, z);
+		};
+		auto getRotation = [&get]() {
+			const float x = dequantise(get(), STATE_ROTATION_STEP);
+			const float y = dequantise(get(), STATE_ROTATION_STEP);
+			const float z = dequantise(get(), STATE_ROTATION_STEP);
+			const float w = dequantise(get(), STATE_ROTATION_STEP);
+			return Quaternion::normalise(Quaternion(x, y, z, w));
+		};
+		auto getBits = [&get]() {
+			const float x = fromBits(get());
+			const float y = fromBits(get());
+			const float z = fromBits(get());
+			return Vector3D(x, y, z);
+		};
+
+		state.dt = fromBits(get());
+		state.ship_position = getVector(STATE_POSITION_STEP);
+		state.ship_velocity = getVector(STATE_VELOCITY_STEP);
+		state.ship_rotation = getRotation();
+		state.camera_position = getVector(STATE_POSITION_STEP);
+		state.camera_rotation = getRotation();
+		state.satellite_position = getBits();
+		state.satellite_axis = getBits();
+		state.satellite_angle = dequantise(get(), STATE_ANGLE_STEP);
+		state.red_walls = static_cast<std::uint8_t>(get());
+		state.asteroid_count = static_cast<float>(get());
+		state.level_timer = dequantise(get(), STATE_TIMER_STEP);
+	}
+
+	Entity quantiseEntity(const EntityState& state) {
+		Entity entity;
+		entity.id = state.id;
+		entity.kind = state.kind;
+		entity.fields = {
+			quantise(state.position.X, STATE_POSITION_STEP),
+			quantise(state.position.Y, STATE_POSITION_STEP),
+			quantise(state.position.Z, STATE_POSITION_STEP),
+			quantise(state.velocity.X, STATE_VELOCITY_STEP),
+			quantise(state.velocity.Y, STATE_VELOCITY_STEP),
+			quantise(state.velocity.Z, STATE_VELOCITY_STEP),
+			quantiseAngle(state.angle),
+			state.health,
+			state.frame,
+			state.in_arena ? 1 : 0 };
+		entity.spawn = {
+			toBits(state.radius),
+			toBits(state.seed),
+			state.texture_layer,
+			toBits(state.rotation_axis.X),
+			toBits(state.rotation_axis.Y),
+			toBits(state.rotation_axis.Z),
+			toBits(state.rotation_speed),
+			state.rotation_direction };
+		return entity;
+	}
+
+	void dequantiseEntity(const Entity& entity, EntityState& state) {
+		const auto& fields = entity.fields;
+		const auto& spawn = entity.spawn;
+		state.id = entity.id;
+		state.kind = entity.kind;
+		state.position = Vector3D(dequantise(fields[0], STATE_POSITION_STEP),
+			dequantise(fields[1], STATE_POSITION_STEP), dequantise(fields[2], STATE_POSITION_STEP));
+		state.velocity = Vector3D(dequantise(fields[3], STATE_VELOCITY_STEP),
+			dequantise(fields[4], STATE_VELOCITY_STEP), dequantise(fields[5], STATE_VELOCITY_STEP));
+		state.angle = dequantise(fields[6], STATE_ANGLE_STEP);
+		state.health = fields[7];
+		state.frame = fields[8];
+		state.in_arena = fields[9] != 0;
+		state.radius = fromBits(spawn[0]);
+		state.seed = fromBits(spawn[1]);
+		state.texture_layer = spawn[2];
+		state.rotation_axis = Vector3D(fromBits(spawn[3]), fromBits(spawn[4]), fromBits(spawn[5]));
+		state.rotation_speed = fromBits(spawn[6]);
+		state.rotation_direction = spawn[7];
+	}
+}
+
+namespace statestream {
+	void putVarint(std::vector<unsigned char>& out, std::uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<unsigned char>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<unsigned char>(value));
+	}
+
+	void quantise(const WorldState& state, State& quantised) {
+		quantiseHeader(state, quantised.header);
+		quantised.entities.clear();
+		for (const EntityState& entity : state.entities) {
+			quantised.entities.push_back(quantiseEntity(entity));
+		}
+		std::sort(quantised.entities.begin(), quantised.entities.end(),
+			[](const Entity& a, const Entity& b) { return a.id < b.id; });
+	}
+
+	void dequantise(const State& quantised, WorldState& state) {
+		dequantiseHeader(quantised.header, state);
+		state.entities.resize(quantised.entities.size());
+		for (size_t i = 0; i < quantised.entities.size(); ++i) {
+			dequantiseEntity(quantised.entities[i], state.entities[i]);
+		}
+	}
+
+	void encode(const State& previous, const State& current, std::vector<unsigned char>& out) {
+		putFields(out, previous.header, current.header);
+
+		size_t despawns = 0;
+		size_t spawns = 0;
+		match(previous.entities, current.entities, [&](const Entity* before, const Entity* after) {
+			despawns += after == nullptr ? 1 : 0;
+			spawns += before == nullptr ? 1 : 0;
+		});
+
+		std::uint64_t last_id = 0;
+		putVarint(out, despawns);
+		match(previous.entities, current.entities, [&](const Entity* before, const Entity* after) {
+			if (after == nullptr) {
+				putVarint(out, before->id - last_id);
+				last_id = before->id;
+			}
+		});
+
+		last_id = 0;
+		putVarint(out, spawns);
+		match(previous.entities, current.entities, [&](const Entity* before, const Entity* after) {
+			if (before == nullptr) {
+				putVarint(out, after->id - last_id);
+				last_id = after->id;
+				out.push_back(static_cast<unsigned char>(after->kind));
+				putFields(out, NO_FIELDS, after->fields);
+				putFields(out, NO_SPAWN, after->spawn);
+			}
+		});
+
+		match(previous.entities, current.entities, [&](const Entity* before, const Entity* after) {
+			if (before != nullptr && after != nullptr) {
+				putFields(out, before->fields, after->fields);
+			}
+		});
+	}
+
+	bool decode(const unsigned char* data, size_t size, const State& previous, State& current, Scratch& scratch) {
+		std::vector<std::uint64_t>& despawned = scratch.despawned;
+		std::vector<Entity>& spawned = scratch.spawned;
+		std::vector<Entity>& kept = scratch.kept;
+		Payload in(data, size);
+		if (!getFields(in, previous.header, current.header)) {
+			return false;
+		}
+
+		std::uint64_t count;
+		std::uint64_t id = 0;
+		if (!in.varint(count) || count > previous.entities.size()) {
+			return false;
+		}
+		despawned.clear();
+		for (std::uint64_t i = 0; i < count; ++i) {
+			std::uint64_t difference;
+			if (!in.varint(difference)) {
+				return false;
+			}
+			id += difference;
+			despawned.push_back(id);
+		}
+
+		// every spawn takes at least four bytes
+		id = 0;
+		if (!in.varint(count) || count > in.remaining() / 4) {
+			return false;
+		}
+		spawned.clear();
+		for (std::uint64_t i = 0; i < count; ++i) {
+			std::uint64_t difference;
+			std::uint8_t kind;
+			if (!in.varint(difference) || !in.byte(kind) || kind > static_cast<std::uint8_t>(EntityKind::explosion)) {
+				return false;
+			}
+			id += difference;
+			spawned.push_back({ id, static_cast<EntityKind>(kind), {}, {} });
+			if (!getFields(in, NO_FIELDS, spawned.back().fields) || !getFields(in, NO_SPAWN, spawned.back().spawn)) {
+				return false;
+			}
+		}
+
+		// Both lists are in id order, so the despawned ones turn up in order too
+		kept.clear();
+		size_t next_despawn = 0;
+		for (const Entity& before : previous.entities) {
+			if (next_despawn < despawned.size() && despawned[next_despawn] == before.id) {
+				++next_despawn;
+				continue;
+			}
+			kept.push_back(before);
+			if (!getFields(in, before.fields, kept.back().fields)) {
+				return false;
+			}
+		}
+		if (next_despawn != despawned.size() || in.remaining() != 0) {
+			return false;
+		}
+
+		current.entities.clear();
+		std::merge(kept.begin(), kept.end(), spawned.begin(), spawned.end(), std::back_inserter(current.entities),
+			[](const Entity& a, const Entity& b) { return a.id < b.id; });
+		return true;
+	}
+}
@@ -0,0 +1,58 @@
+#ifndef I3D_STATECODEC_H
+#define I3D_STATECODEC_H
+
+#include "WorldState.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The encoding shared by state streams and the snapshots a server sends.
+// A WorldState is first quantised to fixed point (see StateConstants.h),
+// then encoded as a delta against an earlier one: what despawned, what
+// spawned and, for everything else, only the fields that changed, all as
+// zigzag varints. An asteroid drifting in a straight line costs a few bytes.
+// Against an empty State the delta is the whole world.
+
+namespace statestream {
+	size_t constexpr HEADER_FIELDS = 28;
+	size_t constexpr ENTITY_FIELDS = 10; // the ones that change tick to tick
+	size_t constexpr SPAWN_FIELDS = 8; // the ones that don't
+
+	// A WorldState in fixed point. Deltas are taken between these rather
+	// than the floats, so decoding a run of them gets back exactly what was
+	// encoded without drifting
+	struct Entity {
+		std::uint64_t id;
+		EntityKind kind;
+		std::array<std::int32_t, ENTITY_FIELDS> fields;
+		std::array<std::int32_t, SPAWN_FIELDS> spawn;
+	};
+
+	struct State {
+		std::array<std::int32_t, HEADER_FIELDS> header;
+		std::vector<Entity> entities; // by id
+	};
+
+	// Lists decode() works in, kept between calls so it stops allocating
+	struct Scratch {
+		std::vector<std::uint64_t> despawned;
+		std::vector<Entity> spawned;
+		std::vector<Entity> kept;
+	};
+
+	void quantise(const WorldState& state, State& quantised);
+	void dequantise(const State& quantised, WorldState& state);
+
+	// Appends current as a delta against previous
+	void encode(const State& previous, const State& current, std::vector<unsigned char>& out);
+
+	// false, leaving current in an unspecified state, if the data isn't
+	// exactly one delta against previous
+	bool decode(const unsigned char* data, size_t size, const State& previous, State& current, Scratch& scratch);
+
+	void putVarint(std::vector<unsigned char>& out, std::uint64_t value);
+}
+
+#endif // I3D_STATECODEC_H
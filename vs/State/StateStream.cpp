@@ -0,0 +1,220 @@
+#include "StateStream.h"
+#include "Constants/StateConstants.h"
+
+#include <algorithm>
+#include <iostream>
+
+using statestream::State;
+using statestream::putVarint;
+
+namespace {
+	const char MAGIC[4] = { 'I', '3', 'D', 'S' };
+	const std::uint32_t VERSION = 1;
+
+	const std::uint8_t KEYFRAME = 1;
+	const std::uint8_t DELTA = 2;
+
+	template <typename T>
+	bool get(std::ifstream& file, T& value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	bool getVarint(std::istream& file, std::uint64_t& value) {
+		value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			const int byte = file.get();
+			if (byte == std::char_traits<char>::eof()) {
+				return false;
+			}
+			value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+StateRecorder::StateRecorder()
+	: keyframe_interval(STATE_KEYFRAME_INTERVAL)
+	, tick(0)
+	, keyframes(0)
+	, bytes_written(0)
+	, previous()
+	, current() {}
+
+bool StateRecorder::open(const std::string& filename, int keyframe_interval) {
+	file.open(filename, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cerr << "Failed to open " << filename << " for recording state" << std::endl;
+		return false;
+	}
+	this->keyframe_interval = std::max(1, keyframe_interval);
+
+	const std::uint32_t interval = static_cast<std::uint32_t>(this->keyframe_interval);
+	file.write(MAGIC, sizeof(MAGIC));
+	file.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+	file.write(reinterpret_cast<const char*>(&interval), sizeof(interval));
+	file.flush();
+	bytes_written = sizeof(MAGIC) + sizeof(VERSION) + sizeof(interval);
+	return true;
+}
+
+// Nothing here allocates once the buffers have grown to the size of the game
+void StateRecorder::write(const WorldState& state) {
+	statestream::quantise(state, current);
+
+	const bool keyframe = tick % keyframe_interval == 0;
+	static const State empty = {};
+	payload.clear();
+	statestream::encode(keyframe ? empty : previous, current, payload);
+
+	record.clear();
+	record.push_back(keyframe ? KEYFRAME : DELTA);
+	putVarint(record, tick);
+	putVarint(record, payload.size());
+
+	file.write(reinterpret_cast<const char*>(record.data()), record.size());
+	file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+	file.flush();
+
+	bytes_written += record.size() + payload.size();
+	keyframes += keyframe ? 1 : 0;
+	++tick;
+	std::swap(previous, current);
+}
+
+void StateRecorder::report(std::ostream& out) const {
+	out << "State stream: " << tick << " ticks, " << keyframes << " keyframes, "
+		<< bytes_written / 1024.0 << " KiB (" << (tick > 0 ? bytes_written / static_cast<double>(tick) : 0)
+		<< " bytes/tick)" << std::endl;
+}
+
+StatePlayer::StatePlayer()
+	: tick_count(0)
+	, scanned(0)
+	, position(0)
+	, next_tick(0)
+	, empty()
+	, current()
+	, decoded() {}
+
+bool StatePlayer::open(const std::string& filename) {
+	file.open(filename, std::ios::binary);
+	if (!file) {
+		std::cerr << "Failed to open " << filename << " for playback" << std::endl;
+		return false;
+	}
+
+	char magic[4];
+	std::uint32_t version;
+	std::uint32_t interval;
+	if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, MAGIC)
+		|| !get(file, version) || version != VERSION || !get(file, interval)) {
+		std::cerr << filename << " is not a state stream this build can play" << std::endl;
+		return false;
+	}
+
+	scanned = file.tellg();
+	position = scanned;
+	refresh();
+	return true;
+}
+
+// Only reads the record headers, skipping over the payloads, and notes where
+// each keyframe starts for seeking
+void StatePlayer::refresh() {
+	file.clear();
+	file.seekg(0, std::ios::end);
+	const std::streamoff end = file.tellg();
+	file.seekg(scanned);
+
+	while (true) {
+		const std::streamoff start = file.tellg();
+		std::uint8_t kind;
+		std::uint64_t tick;
+		std::uint64_t size;
+		if (!get(file, kind) || !getVarint(file, tick) || !getVarint(file, size)
+			|| static_cast<std::uint64_t>(end - file.tellg()) < size) {
+			break; // cut off, maybe still being written
+		}
+		if (tick != tick_count || (kind != KEYFRAME && kind != DELTA) || (tick == 0 && kind != KEYFRAME)) {
+			std::cerr << "State stream is corrupt at tick " << tick_count << ", playing up to there" << std::endl;
+			break;
+		}
+
+		if (kind == KEYFRAME) {
+			keyframes.push_back({ tick, start });
+		}
+		file.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+		scanned = file.tellg();
+		++tick_count;
+	}
+	file.clear();
+}
+
+std::uint64_t StatePlayer::getTickCount() const {
+	return tick_count;
+}
+
+std::uint64_t StatePlayer::getTick() const {
+	return next_tick;
+}
+
+bool StatePlayer::seek(std::uint64_t tick) {
+	if (tick_count == 0) {
+		return false;
+	}
+	tick = std::min(tick, tick_count - 1);
+
+	// Decoding on from where it is beats going back to the keyframe, if it's
+	// behind the target but not behind the keyframe
+	auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), tick,
+		[](std::uint64_t tick, const Keyframe& keyframe) { return tick < keyframe.tick; });
+	--keyframe;
+	if (tick < next_tick || keyframe->tick > next_tick) {
+		position = keyframe->offset;
+		next_tick = keyframe->tick;
+	}
+
+	while (next_tick < tick) {
+		if (!step()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool StatePlayer::read(WorldState& state) {
+	if (next_tick >= tick_count || !step()) {
+		return false;
+	}
+
+	statestream::dequantise(current, state);
+	return true;
+}
+
+bool StatePlayer::step() {
+	file.clear();
+	file.seekg(position);
+
+	std::uint8_t kind;
+	std::uint64_t tick;
+	std::uint64_t size;
+	if (!get(file, kind) || !getVarint(file, tick) || !getVarint(file, size)) {
+		return false;
+	}
+	record.resize(size);
+	if (!file.read(reinterpret_cast<char*>(record.data()), size)) {
+		return false;
+	}
+
+	if (!statestream::decode(record.data(), record.size(), kind == KEYFRAME ? empty : current, decoded, scratch)) {
+		std::cerr << "Couldn't decode state stream tick " << tick << std::endl;
+		return false;
+	}
+	std::swap(current, decoded);
+	position = file.tellg();
+	++next_tick;
+	return true;
+}
@@ -0,0 +1,84 @@
+#ifndef I3D_STATESTREAM_H
+#define I3D_STATESTREAM_H
+
+#include "StateCodec.h"
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// State stream file: a header, then one record per tick. Every
+// STATE_KEYFRAME_INTERVAL ticks the record is a keyframe holding the whole
+// world; in between it's a delta against the tick before (see StateCodec.h).
+//
+// Each record is written and flushed whole, so a file can be played while
+// it's still being recorded; a reader ignores a record cut off at the end.
+// Native byte order for the header, like the input recordings.
+
+class StateRecorder {
+public:
+	StateRecorder();
+
+	bool open(const std::string& filename, int keyframe_interval);
+	void write(const WorldState& state);
+
+	void report(std::ostream& out) const;
+
+private:
+	std::ofstream file;
+	int keyframe_interval;
+	std::uint64_t tick;
+	std::uint64_t keyframes;
+	std::uint64_t bytes_written;
+
+	statestream::State previous;
+	statestream::State current;
+	std::vector<unsigned char> record;
+	std::vector<unsigned char> payload;
+};
+
+class StatePlayer {
+public:
+	StatePlayer();
+
+	bool open(const std::string& filename);
+
+	// Picks up any records written since the file was opened or last refreshed
+	void refresh();
+
+	std::uint64_t getTickCount() const;
+	std::uint64_t getTick() const; // the one read() gives next
+
+	// Goes to the keyframe at or before tick and decodes forward from there,
+	// so it's never more than a keyframe interval of deltas away. Past the
+	// end goes to the last tick
+	bool seek(std::uint64_t tick);
+
+	// false once there's nothing more recorded
+	bool read(WorldState& state);
+
+private:
+	struct Keyframe {
+		std::uint64_t tick;
+		std::streamoff offset;
+	};
+
+	bool step(); // decodes the next record into current
+
+	std::ifstream file;
+	std::vector<Keyframe> keyframes;
+	std::uint64_t tick_count;
+	std::streamoff scanned; // end of the last whole record
+	std::streamoff position; // start of the record for next_tick
+	std::uint64_t next_tick;
+
+	statestream::State empty;
+	statestream::State current;
+	statestream::State decoded;
+	statestream::Scratch scratch;
+	std::vector<unsigned char> record;
+};
+
+#endif // I3D_STATESTREAM_H
@@ -0,0 +1,65 @@
+#ifndef I3D_WORLDSTATE_H
+#define I3D_WORLDSTATE_H
+
+#include "Math/Vector3D.h"
+#include "Math/Quaternion.h"
+
+#include <cstdint>
+#include <vector>
+
+enum class EntityKind : std::uint8_t {
+	asteroid,
+	bullet,
+	explosion
+};
+
+// One asteroid, bullet or explosion particle as the state stream stores it.
+// Unlike a Snapshot this only holds what's needed to show the entity and to
+// carry on simulating from it approximately, and nothing specific to the
+// process that recorded it
+struct EntityState {
+	std::uint64_t id; // unique within a stream; entities are kept sorted by it
+	EntityKind kind;
+
+	// Changes from tick to tick
+	Vector3D position;
+	Vector3D velocity;
+	float angle; // degrees of spin, asteroids only
+	int health;
+	int frame; // animation frame, billboards only
+	bool in_arena;
+
+	// Fixed from the tick it spawns, asteroids only
+	float radius;
+	float seed;
+	int texture_layer;
+	Vector3D rotation_axis;
+	float rotation_speed;
+	int rotation_direction;
+};
+
+// Everything visible in one tick, plus the level timer, for the state stream.
+// GameManager::captureState fills one in and applyState puts it back
+struct WorldState {
+	float dt;
+
+	Vector3D ship_position;
+	Vector3D ship_velocity;
+	Quaternion ship_rotation;
+
+	Vector3D camera_position;
+	Quaternion camera_rotation;
+
+	Vector3D satellite_position;
+	Vector3D satellite_axis;
+	float satellite_angle;
+
+	std::uint8_t red_walls; // bit i set when the arena's wall i is showing the warning
+
+	float asteroid_count; // of the next wave
+	float level_timer;
+
+	std::vector<EntityState> entities; // by id
+};
+
+#endif // I3D_WORLDSTATE_H
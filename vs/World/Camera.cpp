@@ -7,8 +7,6 @@
 #include "Camera.h"
 #include "Constants/CameraConstants.h"
 
-#include "GlutHeaders.h"
-
 Quaternion Camera::rotation = Quaternion::identity();
 
 Camera::Camera() :
@@ -39,12 +37,24 @@ const float& Camera::getZFar() const { return zfar; }
 const float& Camera::getAspect() const { return aspect; };
 void Camera::setAspect(const float& aspect) { this->aspect = aspect; }
 
-// If we want to look up, then we rotate the world down, so we need the camera's
-// inverse quaternion to use with glMultMatrixf
-void Camera::rotate() {
-	glMultMatrixf(Quaternion::toMatrix(Quaternion::inverse(rotation)).data());
+void Camera::save(Snapshot& snapshot) const {
+	snapshot.write(position);
+	snapshot.write(rotation);
+	snapshot.write(look_at);
+}
+
+void Camera::restore(Snapshot::Reader& reader) {
+	reader.read(position);
+	reader.read(rotation);
+	reader.read(look_at);
+}
+
+void Camera::captureState(WorldState& state) const {
+	state.camera_position = position;
+	state.camera_rotation = rotation;
 }
 
-void Camera::translate() {
-	glTranslatef(-position.X, -position.Y, -position.Z);
+void Camera::applyState(const WorldState& state) {
+	position = state.camera_position;
+	rotation = state.camera_rotation;
 }
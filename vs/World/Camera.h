@@ -5,6 +5,8 @@
 #include "Math/Quaternion.h"
 
 #include "Enums/Enum.h"
+#include "State/Snapshot.h"
+#include "State/WorldState.h"
 
 class Camera {
 public:
@@ -25,9 +27,14 @@ public:
 	const float& getAspect() const;
 	void setAspect(const float& aspect);
 
+	// Where it's got to lerping after the ship, and which way it's looking
+	void save(Snapshot& snapshot) const;
+	void restore(Snapshot::Reader& reader);
+
+	void captureState(WorldState& state) const;
+	void applyState(const WorldState& state);
+
 
-	void translate();
-	void rotate();
 	Look look_at;
 
 private:
@@ -1,26 +1,64 @@
 #include "GlutHeaders.h"
 #include "GameManager.h"
 
+#ifdef FREEGLUT
+#   include <GL/freeglut_ext.h>
+#endif
+
 #include "Math/Quaternion.h"
 #include "Math/Vector3D.h"
+#include "Math/Utility.h"
 
 #include "Assets/Asset.h"
+#include "Assets/ResourceManager.h"
+#include "Platform/Offscreen.h"
+#include "Platform/VSync.h"
+#include "Benchmark/Benchmark.h"
+#include "Profiling/AllocationTracker.h"
+#include "Memory/FrameArena.h"
+#include "Constants/AsteroidConstants.h"
+#include "Constants/RenderConstants.h"
+#include "Constants/BenchmarkConstants.h"
+#include "Constants/StateConstants.h"
+#include "Constants/NetConstants.h"
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
 // Global game manager pointer
 std::unique_ptr<GameManager> game;
 
 void initGlut(int argc, char** argv);
+void initGlew();
 void initCallbacks();
 void initFeatures();
 void initTextures();
+void releaseResources();
+
+bool hasFlag(int argc, char** argv, const char* flag);
+const char* findArgument(int argc, char** argv, const char* flag);
+bool createGame(int argc, char** argv);
+void configurePacing(int argc, char** argv);
+int offscreenFrames(int argc, char** argv);
+int runOffscreen(int argc, char** argv, int frame_count);
+int runBenchmark(int argc, char** argv);
+int runServer(int argc, char** argv);
 
 // Callback functions
 void reshapeCallback(int w, int h);
 void displayCallback();
 void idleCallback();
+void interruptCallback(int signal);
 
 void keyboardDownCallback(unsigned char key, int x, int y);
 void keyboardUpCallback(unsigned char key, int x, int y);
@@ -30,14 +68,337 @@ void mouseClickDragCallback(int x, int y);
 void mouseClickCallback(int button, int state, int x, int y);
 
 int main(int argc, char** argv) {
+	if (hasFlag(argc, argv, "--track-allocations")) {
+		AllocationTracker::setEnabled(true);
+	}
+	// "--gpu-budget <MiB>" for textures and buffers, past which it warns
+	if (const char* budget = findArgument(argc, argv, "--gpu-budget")) {
+		ResourceManager::setBudget(static_cast<size_t>(std::max(0.0, std::atof(budget)) * (1 << 20)));
+	}
+
+	if (hasFlag(argc, argv, "--benchmark") || hasFlag(argc, argv, "--stress")) {
+		return runBenchmark(argc, argv);
+	}
+	if (hasFlag(argc, argv, "--server")) {
+		return runServer(argc, argv);
+	}
+
+	int frame_count = offscreenFrames(argc, argv);
+	if (frame_count > 0) {
+		return runOffscreen(argc, argv, frame_count);
+	}
+
 	initGlut(argc, argv);
+	initGlew();
 	initCallbacks();
 	initFeatures();
 	initTextures();
 
-	game = std::make_unique<GameManager>();
+	if (!createGame(argc, argv)) {
+		return EXIT_FAILURE;
+	}
+	configurePacing(argc, argv);
 	game->start();
 
+	// The window, and the context with it, is already gone by now
+	ResourceManager::report(std::cout);
+
+	return EXIT_SUCCESS;
+}
+
+bool hasFlag(int argc, char** argv, const char* flag) {
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], flag) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The argument following flag, or nullptr if the flag isn't there
+const char* findArgument(int argc, char** argv, const char* flag) {
+	for (int i = 1; i + 1 < argc; ++i) {
+		if (std::strcmp(argv[i], flag) == 0) {
+			return argv[i + 1];
+		}
+	}
+	return nullptr;
+}
+
+// "--record <file>" saves the session's seed and per tick input, "--replay <file>"
+// plays one back. The RNG has to be seeded before the game exists, as the
+// satellite and the first asteroids are placed randomly on construction.
+// "--record-state <file>" writes a state stream of the session as it's played,
+// which "--play-state <file>" shows again, from "--seek <tick>" and at "--speed
+// <ticks per tick>" if given.
+// "--connect <host:port>" watches a server's game instead of playing one.
+// "--no-occlusion" draws everything, hidden or not, and "--hud" starts with the
+// performance overlay showing
+bool createGame(int argc, char** argv) {
+	std::unique_ptr<InputRecorder> recorder;
+	std::unique_ptr<InputReplayer> replayer;
+	std::unique_ptr<StateRecorder> state_recorder;
+	std::unique_ptr<StatePlayer> state_player;
+	std::unique_ptr<SnapshotClient> client;
+	std::uint32_t seed = std::random_device()();
+
+	if (const char* filename = findArgument(argc, argv, "--replay")) {
+		replayer = std::make_unique<InputReplayer>();
+		if (!replayer->open(filename)) {
+			return false;
+		}
+		seed = replayer->getSeed();
+	}
+	else if (const char* filename = findArgument(argc, argv, "--record")) {
+		recorder = std::make_unique<InputRecorder>();
+		if (!recorder->open(filename, seed)) {
+			return false;
+		}
+	}
+
+	if (const char* filename = findArgument(argc, argv, "--play-state")) {
+		state_player = std::make_unique<StatePlayer>();
+		if (!state_player->open(filename)) {
+			return false;
+		}
+		if (const char* tick = findArgument(argc, argv, "--seek")) {
+			state_player->seek(std::strtoull(tick, nullptr, 10));
+		}
+	}
+	else if (const char* filename = findArgument(argc, argv, "--record-state")) {
+		state_recorder = std::make_unique<StateRecorder>();
+		if (!state_recorder->open(filename, STATE_KEYFRAME_INTERVAL)) {
+			return false;
+		}
+	}
+
+	if (const char* address = findArgument(argc, argv, "--connect")) {
+		NetAddress server;
+		if (!NetAddress::parse(address, server)) {
+			std::cerr << address << " isn't a host:port to connect to" << std::endl;
+			return false;
+		}
+		client = std::make_unique<SnapshotClient>();
+		if (!client->connect(server)) {
+			return false;
+		}
+	}
+
+	utility::seed(seed);
+
+	game = std::make_unique<GameManager>();
+	game->setOcclusionCulling(!hasFlag(argc, argv, "--no-occlusion"));
+	game->setHudVisible(hasFlag(argc, argv, "--hud"));
+	game->setInputRecorder(std::move(recorder));
+	game->setInputReplayer(std::move(replayer));
+	game->setStateRecorder(std::move(state_recorder));
+	game->setStatePlayer(std::move(state_player));
+	game->setSnapshotClient(std::move(client));
+	if (const char* speed = findArgument(argc, argv, "--speed")) {
+		game->setPlaybackSpeed(static_cast<float>(std::atof(speed)));
+	}
+	return true;
+}
+
+// "--fps <rate>" caps the display loop (0 = as fast as it'll go), "--tick-rate
+// <rate>" the simulation, and "--no-vsync" stops swaps waiting for the vertical
+// blank. With vsync on the swap already holds drawing to the monitor's rate,
+// so the display loop is only paced by the clock if asked to be or if the
+// driver wouldn't take the swap interval
+void configurePacing(int argc, char** argv) {
+	const bool vsync_off = hasFlag(argc, argv, "--no-vsync");
+	const bool vsync_on = !vsync_off && vsync::setInterval(SWAP_INTERVAL);
+	if (vsync_off) {
+		vsync::setInterval(0);
+	}
+	else if (!vsync_on) {
+		std::cout << "Couldn't set a swap interval, pacing by the clock instead" << std::endl;
+	}
+
+	const char* frame_rate = findArgument(argc, argv, "--fps");
+	game->setFrameRate(frame_rate ? std::max(0.0, std::atof(frame_rate)) : vsync_on ? 0 : FRAME_RATE);
+
+	const char* tick_rate = findArgument(argc, argv, "--tick-rate");
+	game->setTickRate(tick_rate ? std::max(0.0, std::atof(tick_rate)) : TICK_RATE);
+}
+
+// "--offscreen [frames]" renders without a window, e.g. on a CI host with no
+// display server. Returns 0 when it isn't given
+int offscreenFrames(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--offscreen") == 0) {
+			return i + 1 < argc ? std::max(1, std::atoi(argv[i + 1])) : OFFSCREEN_FRAMES;
+		}
+	}
+	return 0;
+}
+
+// Same game and display path as the windowed build, but the frames go to a
+// framebuffer object and a frame counter takes the place of glutMainLoop
+int runOffscreen(int argc, char** argv, int frame_count) {
+	Offscreen offscreen;
+	if (!offscreen.create(OFFSCREEN_WIDTH, OFFSCREEN_HEIGHT)) {
+		return EXIT_FAILURE;
+	}
+
+	initFeatures();
+	initTextures();
+
+	if (!createGame(argc, argv)) {
+		return EXIT_FAILURE;
+	}
+	game->setHeadless(true);
+	game->onReshape(offscreen.getWidth(), offscreen.getHeight());
+
+	const auto start = std::chrono::steady_clock::now();
+	const int frames = game->run(frame_count);
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << frames << " frames in " << elapsed.count() << " ms ("
+		<< elapsed.count() / std::max(frames, 1) << " ms/frame)" << std::endl;
+	FrameArena::report(std::cout);
+	ResourceManager::report(std::cout);
+
+	releaseResources();
+	return EXIT_SUCCESS;
+}
+
+// "--benchmark [scenario]" times one scenario, or all of them, headless.
+// "--stress [population]" instead grows one asteroid field towards population,
+// timing it at each doubling, with at most "--spawn-rate <n>" new asteroids a tick.
+// Either way:
+//	--render			draw every tick too, not just simulate it
+//	--no-occlusion		and draw what's hidden as well
+//	--json <file>		write the results there rather than to stdout
+//	--baseline <file>	compare against an earlier --json, failing on regressions
+//	--threshold <%>		how much slower counts as a regression
+//	--track-allocations	count heap allocations per phase as well
+//	--assert-steady-state	abort on any allocation while recording or rendering
+//	--from-state <file>	start every scenario from a moment of a state stream,
+//	--seek <tick>		this one rather than the first
+int runBenchmark(int argc, char** argv) {
+	const bool stress = hasFlag(argc, argv, "--stress");
+
+	std::vector<const Scenario*> scenarios;
+	const char* name = findArgument(argc, argv, "--benchmark");
+	if (stress) {
+		// no scenarios, the field is the whole run
+	}
+	else if (name != nullptr && name[0] != '-') {
+		const Scenario* scenario = scenario::find(name);
+		if (scenario == nullptr) {
+			std::cerr << "No scenario called " << name << ", try one of:" << std::endl;
+			for (const Scenario& known : scenario::all()) {
+				std::cerr << "  " << known.name << std::endl;
+			}
+			return EXIT_FAILURE;
+		}
+		scenarios.push_back(scenario);
+	}
+	else {
+		for (const Scenario& scenario : scenario::all()) {
+			scenarios.push_back(&scenario);
+		}
+	}
+
+	Offscreen offscreen;
+	if (!offscreen.create(OFFSCREEN_WIDTH, OFFSCREEN_HEIGHT)) {
+		return EXIT_FAILURE;
+	}
+	initFeatures();
+	initTextures();
+
+	Benchmark benchmark(hasFlag(argc, argv, "--render"), offscreen.getWidth(), offscreen.getHeight());
+	benchmark.setOcclusionCulling(!hasFlag(argc, argv, "--no-occlusion"));
+	const bool strict = hasFlag(argc, argv, "--assert-steady-state");
+	if (strict || AllocationTracker::isEnabled()) {
+		benchmark.trackAllocations(strict);
+	}
+	if (const char* filename = findArgument(argc, argv, "--from-state")) {
+		StatePlayer player;
+		const char* tick = findArgument(argc, argv, "--seek");
+		WorldState state;
+		if (!player.open(filename) || !player.seek(tick ? std::strtoull(tick, nullptr, 10) : 0) || !player.read(state)) {
+			std::cerr << "Couldn't read a starting state from " << filename << std::endl;
+			releaseResources();
+			return EXIT_FAILURE;
+		}
+		std::cerr << "Starting from tick " << player.getTick() - 1 << " of " << filename << std::endl;
+		benchmark.setStartingState(state);
+	}
+	std::vector<ScenarioResult> results;
+	if (stress) {
+		const char* population = findArgument(argc, argv, "--stress");
+		const char* spawn_rate = findArgument(argc, argv, "--spawn-rate");
+		results = benchmark.stress(
+			population && population[0] != '-' ? std::max(1, std::atoi(population)) : STRESS_POPULATION,
+			spawn_rate ? std::max(1, std::atoi(spawn_rate)) : STRESS_SPAWN_RATE);
+	}
+	for (const Scenario* scenario : scenarios) {
+		std::cerr << "Running " << scenario->name << std::endl;
+		results.push_back(benchmark.run(*scenario));
+	}
+	FrameArena::report(std::cerr); // stdout may be the JSON
+	ResourceManager::report(std::cerr);
+	releaseResources();
+
+	if (const char* filename = findArgument(argc, argv, "--json")) {
+		std::ofstream file(filename);
+		Benchmark::writeJson(file, results);
+	}
+	else {
+		Benchmark::writeJson(std::cout, results);
+	}
+
+	if (const char* filename = findArgument(argc, argv, "--baseline")) {
+		std::vector<ScenarioResult> baseline;
+		if (!Benchmark::readJson(filename, baseline)) {
+			return EXIT_FAILURE;
+		}
+
+		const char* threshold = findArgument(argc, argv, "--threshold");
+		if (!Benchmark::compare(baseline, results, threshold ? std::atof(threshold) : BENCHMARK_THRESHOLD)) {
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
+
+// "--server [port]" simulates the game with no window, context or assets,
+// sending snapshots of it to anyone who connects, at "--tick-rate <rate>"
+// with a fixed time step. It runs for "--ticks <n>" ticks, or until it's
+// interrupted. "--replay <file>" gives the ship something to do, and
+// "--population <n>" keeps that many asteroids in play, with the ship
+// invulnerable so they aren't all cleared away by the first hit
+int runServer(int argc, char** argv) {
+	const char* port = findArgument(argc, argv, "--server");
+	auto server = std::make_unique<SnapshotServer>();
+	if (!server->open(port && port[0] != '-' ? static_cast<std::uint16_t>(std::atoi(port)) : NET_PORT)) {
+		return EXIT_FAILURE;
+	}
+	if (!createGame(argc, argv)) {
+		return EXIT_FAILURE;
+	}
+
+	const char* tick_rate = findArgument(argc, argv, "--tick-rate");
+	const double rate = tick_rate ? std::max(1.0, std::atof(tick_rate)) : TICK_RATE;
+	game->setThreaded(false);
+	game->setHeadless(true);
+	game->setTickRate(rate);
+	game->setFixedTimeStep(static_cast<float>(1 / rate));
+	game->setSnapshotServer(std::move(server));
+	std::signal(SIGINT, interruptCallback);
+
+	const char* population = findArgument(argc, argv, "--population");
+	if (population) {
+		game->setShipInvulnerable(true);
+	}
+
+	const char* ticks = findArgument(argc, argv, "--ticks");
+	game->serve(ticks ? std::max(0, std::atoi(ticks)) : 0, population ? std::max(0, std::atoi(population)) : 0);
+
+	// no context, so nothing to release but the game
+	game.reset();
 	return EXIT_SUCCESS;
 }
 
@@ -48,6 +409,20 @@ void initGlut(int argc, char** argv) {
 	glutCreateWindow("Asteroid Arena");
 	//glutFullScreen();
 	glutIgnoreKeyRepeat(GLUT_KEY_REPEAT_OFF);
+	glutSetCursor(GLUT_CURSOR_NONE);
+
+#ifdef FREEGLUT
+	// let glutMainLoop return on close so the simulation thread can be joined
+	glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+#endif
+}
+
+// Needs a current context, so must come after the window is created
+void initGlew() {
+	GLenum err = glewInit();
+	if (err != GLEW_OK) {
+		std::cerr << "GLEW: " << glewGetErrorString(err) << std::endl;
+	}
 }
 
 void initCallbacks() {
@@ -66,7 +441,6 @@ void initFeatures() {
 	glEnable(GL_LIGHTING);
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_CULL_FACE);
-	glutSetCursor(GLUT_CURSOR_NONE);
 	glEnable(GL_NORMALIZE);
 
 	glClearColor(0, 0, 0, 0);
@@ -74,24 +448,28 @@ void initFeatures() {
 
 // bool rgba, bool clamp)
 void initTextures() {
-	Asset::setClamp(true);
-	Asset::loadAsset(Entity::skybox_top, "./Assets/Skybox/top.png");
-	Asset::loadAsset(Entity::skybox_bottom, "./Assets/Skybox/bottom.png");
-	Asset::loadAsset(Entity::skybox_left, "./Assets/Skybox/left.png");
-	Asset::loadAsset(Entity::skybox_right, "./Assets/Skybox/right.png");
-	Asset::loadAsset(Entity::skybox_front, "./Assets/Skybox/front.png");
-	Asset::loadAsset(Entity::skybox_back, "./Assets/Skybox/back.png");
-
-	Asset::setClamp(false);
+	Asset::loadCubeMap(Entity::skybox, {
+		"./Assets/Skybox/right.png",
+		"./Assets/Skybox/left.png",
+		"./Assets/Skybox/top.png",
+		"./Assets/Skybox/bottom.png",
+		"./Assets/Skybox/back.png",
+		"./Assets/Skybox/front.png" });
+
 	Asset::loadAsset(Entity::ship, "./Assets/Ship/Star_Fox_logo_2015.jpeg");
-	Asset::loadAsset(Entity::asteroid_1, "./Assets/Asteroids/asteroid1.jpg");
-	Asset::loadAsset(Entity::asteroid_2, "./Assets/Asteroids/asteroid2.jpg");
-	Asset::loadAsset(Entity::asteroid_3, "./Assets/Asteroids/asteroid3.jpg");
-	Asset::loadAsset(Entity::asteroid_4, "./Assets/Asteroids/asteroid4.jpg");
+	Asset::loadAssetArray(Entity::asteroid_array,
+		std::vector<std::string>(std::begin(ASTEROID_TEXTURES), std::end(ASTEROID_TEXTURES)));
 	Asset::loadAsset(Entity::bullets, "./Assets/Bullets/fireball_ani.png");
 	Asset::loadAsset(Entity::explosion, "./Assets/Explosion/explosion.png");
 }
 
+// GL resources have to go before the context does
+void releaseResources() {
+	game.reset();
+	Asset::clear();
+	ResourceManager::flush();
+}
+
 void reshapeCallback(int w, int h) {
 	game->onReshape(w, h);
 }
@@ -122,4 +500,9 @@ void displayCallback() {
 
 void idleCallback() {
 	game->onIdle();
+}
+
+// Lets a server finish its tick and report before exiting
+void interruptCallback(int) {
+	game->finish();
 }
\ No newline at end of file